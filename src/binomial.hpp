@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <numeric>
+#include <span>
+
+#include "factorial.hpp"
+
+// Binomial and multinomial coefficients for shoe compositions. C(n, k) for
+// n <= pascal_max_n is one load from a constexpr Pascal triangle: row 67 is
+// the last whose every entry fits in 64 bits. Larger n are computed
+// exactly in 128 bits, reporting factorial_error::overflow when the result
+// does not fit, and the log-space functions cover everything beyond that,
+// such as multinomials over the rank counts of an eight-deck shoe.
+
+inline constexpr std::uint32_t pascal_max_n = 67;
+
+namespace binomial_detail {
+    // Row n of the triangle starts at n (n + 1) / 2.
+    constexpr std::size_t pascal_index(std::uint64_t n, std::uint64_t k) {
+        return static_cast<std::size_t>(n * (n + 1) / 2 + k);
+    }
+
+    inline constexpr auto pascal_table = [] {
+        std::array<std::uint64_t, pascal_index(pascal_max_n + 1, 0)> table{};
+        for (std::uint64_t n = 0; n <= pascal_max_n; ++n) {
+            table[pascal_index(n, 0)] = 1;
+            table[pascal_index(n, n)] = 1;
+            for (std::uint64_t k = 1; k < n; ++k) {
+                table[pascal_index(n, k)] = table[pascal_index(n - 1, k - 1)] + table[pascal_index(n - 1, k)];
+            }
+        }
+        return table;
+    }();
+
+    // C(n, k) by C(n, i + 1) = C(n, i) (n - i) / (i + 1). Dividing out
+    // g = gcd(C(n, i), i + 1) first keeps every step exact, and (i + 1) / g
+    // then divides n - i, so nothing overflows before the result does.
+    constexpr std::expected<unsigned __int128, factorial_error> choose_wide(std::uint64_t n, std::uint64_t k) {
+        k = std::min(k, n - k);
+        unsigned __int128 result = 1;
+        for (std::uint64_t i = 0; i < k; ++i) {
+            const std::uint64_t divisor = i + 1;
+            const std::uint64_t g = std::gcd(static_cast<std::uint64_t>(result % divisor), divisor);
+            const unsigned __int128 factor = (n - i) / (divisor / g);
+            if (__builtin_mul_overflow(result / g, factor, &result)) {
+                return std::unexpected(factorial_error::overflow);
+            }
+        }
+        return result;
+    }
+}
+
+constexpr std::expected<unsigned __int128, factorial_error> choose_u128(std::uint64_t n, std::uint64_t k) {
+    if (k > n) return 0;
+    if (n <= pascal_max_n) return binomial_detail::pascal_table[binomial_detail::pascal_index(n, k)];
+    return binomial_detail::choose_wide(n, k);
+}
+
+constexpr std::expected<std::uint64_t, factorial_error> choose_u64(std::uint64_t n, std::uint64_t k) {
+    if (k > n) return 0;
+    if (n <= pascal_max_n) return binomial_detail::pascal_table[binomial_detail::pascal_index(n, k)];
+    const auto wide = binomial_detail::choose_wide(n, k);
+    if (!wide || *wide > UINT64_MAX) return std::unexpected(factorial_error::overflow);
+    return static_cast<std::uint64_t>(*wide);
+}
+
+// (sum of counts)! / (product of count!), as the product of
+// C(c_1 + ... + c_i, c_i) over i.
+constexpr std::expected<unsigned __int128, factorial_error> multinomial(std::span<const std::uint32_t> counts) {
+    unsigned __int128 result = 1;
+    std::uint64_t total = 0;
+    for (std::uint32_t count : counts) {
+        total += count;
+        const auto factor = choose_u128(total, count);
+        if (!factor || __builtin_mul_overflow(result, *factor, &result)) {
+            return std::unexpected(factorial_error::overflow);
+        }
+    }
+    return result;
+}
+
+inline double log_multinomial(std::span<const std::uint32_t> counts) {
+    std::uint64_t total = 0;
+    double result = 0.0;
+    for (std::uint32_t count : counts) {
+        total += count;
+        result -= log_factorial(count);
+    }
+    return result + log_factorial(total);
+}
+
+// Probability that drawing sum(drawn) cards without replacement from a
+// shoe holding shoe[r] cards of rank r gives exactly drawn[r] of each rank:
+// the product of C(shoe[r], drawn[r]) over C(sum(shoe), sum(drawn)). Exact
+// counts are used while they fit in 128 bits, log space after that. A
+// drawn that does not have one count per rank of the shoe, or that asks
+// for more cards of a rank than the shoe holds, has probability 0.
+inline double composition_probability(std::span<const std::uint32_t> shoe, std::span<const std::uint32_t> drawn) {
+    if (drawn.size() != shoe.size()) return 0.0;
+    std::uint64_t shoe_total = 0;
+    std::uint64_t drawn_total = 0;
+    unsigned __int128 ways = 1;
+    bool exact = true;
+    for (std::size_t rank = 0; rank < shoe.size(); ++rank) {
+        if (drawn[rank] > shoe[rank]) return 0.0;
+        shoe_total += shoe[rank];
+        drawn_total += drawn[rank];
+        if (exact) {
+            const auto factor = choose_u128(shoe[rank], drawn[rank]);
+            exact = factor && !__builtin_mul_overflow(ways, *factor, &ways);
+        }
+    }
+    if (exact) {
+        if (const auto draws = choose_u128(shoe_total, drawn_total)) {
+            return static_cast<double>(ways) / static_cast<double>(*draws);
+        }
+    }
+    double log_ways = -log_choose(shoe_total, drawn_total);
+    for (std::size_t rank = 0; rank < shoe.size(); ++rank) {
+        log_ways += log_choose(shoe[rank], drawn[rank]);
+    }
+    return std::exp(log_ways);
+}
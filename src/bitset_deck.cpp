@@ -0,0 +1,121 @@
+#include "bitset_deck.hpp"
+#include <array>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BITSET_DECK_X86 1
+#endif
+
+namespace {
+    constexpr std::uint64_t ones_per_byte = 0x0101010101010101;
+
+    // select_in_byte[b][k]: index of the k-th set bit of byte b.
+    constexpr auto select_in_byte = [] {
+        std::array<std::array<std::uint8_t, 8>, 256> table = {};
+        for (unsigned byte = 0; byte < 256; ++byte) {
+            unsigned k = 0;
+            for (unsigned bit = 0; bit < 8; ++bit) {
+                if (byte >> bit & 1) table[byte][k++] = static_cast<std::uint8_t>(bit);
+            }
+        }
+        return table;
+    }();
+
+    // Broadword select: per-byte popcounts, their prefix sums via one
+    // multiply, a SWAR compare against r to find the byte holding the bit,
+    // then a table lookup inside that byte.
+    unsigned select_bit_portable(std::uint64_t mask, unsigned r) {
+        std::uint64_t counts = mask - ((mask >> 1) & 0x5555555555555555);
+        counts = (counts & 0x3333333333333333) + ((counts >> 2) & 0x3333333333333333);
+        counts = (counts + (counts >> 4)) & 0x0f0f0f0f0f0f0f0f;
+        const std::uint64_t prefix = counts * ones_per_byte;
+
+        // High bit of byte i is set when r >= prefix byte i; prefix sums are
+        // at most 64, so no byte borrows.
+        const std::uint64_t at_or_below = ((r * ones_per_byte) | 0x8080808080808080) - prefix;
+        const unsigned byte = static_cast<unsigned>((((at_or_below & 0x8080808080808080) >> 7) * ones_per_byte) >> 56);
+        const unsigned before = static_cast<unsigned>((prefix << 8) >> (8 * byte)) & 0xff;
+
+        const unsigned bits = static_cast<unsigned>(mask >> (8 * byte)) & 0xff;
+        return 8 * byte + select_in_byte[bits][r - before];
+    }
+
+    // Word holding the rank-th set bit and the rank within it. Branch-free:
+    // the word is the number of cumulative counts at or below rank, and a
+    // rank is equally likely to land in any word, so a search loop would
+    // mispredict on most draws.
+    [[gnu::always_inline]] inline std::pair<std::size_t, unsigned> find_word(
+            const std::uint8_t* counts, std::size_t word_count, unsigned rank) {
+        std::size_t word = 0;
+        unsigned before = 0;
+        unsigned cumulative = 0;
+        for (std::size_t w = 0; w + 1 < word_count; ++w) {
+            cumulative += counts[w];
+            const bool past = rank >= cumulative;
+            word += past;
+            before = past ? cumulative : before;
+        }
+        return {word, rank - before};
+    }
+
+    void take_ranked_portable(std::uint64_t* words, std::uint8_t* counts, const std::uint16_t* ranks,
+                              std::uint16_t* out, std::size_t word_count, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto [word, rank] = find_word(counts, word_count, ranks[i]);
+            const unsigned bit = select_bit_portable(words[word], rank);
+            words[word] ^= std::uint64_t{1} << bit;
+            --counts[word];
+            out[i] = static_cast<std::uint16_t>(64 * word + bit);
+        }
+    }
+
+#ifdef BITSET_DECK_X86
+    // Same loop; PDEP deposits a single bit at the rank-th set position.
+    __attribute__((target("bmi,bmi2"))) void take_ranked_bmi2(
+            std::uint64_t* words, std::uint8_t* counts, const std::uint16_t* ranks,
+            std::uint16_t* out, std::size_t word_count, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto [word, rank] = find_word(counts, word_count, ranks[i]);
+            const std::uint64_t bit_mask = _pdep_u64(std::uint64_t{1} << rank, words[word]);
+            words[word] ^= bit_mask;
+            --counts[word];
+            out[i] = static_cast<std::uint16_t>(64 * word + _tzcnt_u64(bit_mask));
+        }
+    }
+#endif
+}
+
+bool bit_select_supported(bit_select select) {
+    switch (select) {
+        case bit_select::portable: return true;
+#ifdef BITSET_DECK_X86
+        case bit_select::bmi2: return __builtin_cpu_supports("bmi2");
+#endif
+        default: return false;
+    }
+}
+
+bit_select best_bit_select() {
+    static const bit_select best = bit_select_supported(bit_select::bmi2) ? bit_select::bmi2 : bit_select::portable;
+    return best;
+}
+
+const char* bit_select_name(bit_select select) {
+    switch (select) {
+        case bit_select::bmi2: return "BMI2";
+        default: return "portable";
+    }
+}
+
+void bitset_deck_detail::take_ranked(std::uint64_t* words, std::uint8_t* counts, std::size_t word_count,
+                                     const std::uint16_t* ranks, std::uint16_t* out, std::size_t count,
+                                     bit_select select) {
+#ifdef BITSET_DECK_X86
+    if (select == bit_select::bmi2) {
+        take_ranked_bmi2(words, counts, ranks, out, word_count, count);
+        return;
+    }
+#endif
+    take_ranked_portable(words, counts, ranks, out, word_count, count);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "bounded_random.hpp"
+#include "partial_shuffle.hpp"
+#include "random_engines.hpp"
+
+// Dealing as "pick a uniformly random remaining card": the cards still in
+// the deck are the set bits of a few 64-bit masks, and a draw takes a
+// uniform rank r among them and clears the r-th set bit. There is no shuffle
+// pass and no card array to write, only one bit per draw.
+//
+// Finding the r-th set bit of a word is one PDEP and one TZCNT on BMI2
+// machines; elsewhere a broadword select counts bits a byte at a time. The
+// choice is made at run time and both give the same cards.
+
+enum class bit_select { portable, bmi2 };
+
+// Fastest select the running CPU supports.
+bit_select best_bit_select();
+
+bool bit_select_supported(bit_select select);
+
+const char* bit_select_name(bit_select select);
+
+namespace bitset_deck_detail {
+    // For each ranks[i], removes the ranks[i]-th set bit (0-based, counting
+    // from word 0 upwards) of the word_count words and stores its index in
+    // out[i]. counts holds the set bits of each word and is kept up to date.
+    void take_ranked(std::uint64_t* words, std::uint8_t* counts, std::size_t word_count,
+                     const std::uint16_t* ranks, std::uint16_t* out, std::size_t count, bit_select select);
+}
+
+// Cards slots 0 .. Cards - 1, all present after construction or reset().
+// Slots map to cards however the caller likes, e.g. slot % 52 for a shoe.
+template <std::size_t Cards>
+class bitset_deck {
+public:
+    static_assert(Cards > 0 && Cards <= UINT16_MAX);
+    static constexpr std::size_t word_count = (Cards + 63) / 64;
+
+    explicit bitset_deck(bit_select select = best_bit_select()) : select_(select) { reset(); }
+
+    static constexpr std::size_t size() { return Cards; }
+    std::size_t remaining() const { return remaining_; }
+    bool empty() const { return remaining_ == 0; }
+    bool contains(std::size_t slot) const { return words_[slot / 64] >> (slot % 64) & 1; }
+    bit_select select() const { return select_; }
+
+    void reset() {
+        for (std::size_t w = 0; w < word_count; ++w) {
+            const std::size_t bits = std::min<std::size_t>(64, Cards - 64 * w);
+            words_[w] = bits == 64 ? UINT64_MAX : (std::uint64_t{1} << bits) - 1;
+            counts_[w] = static_cast<std::uint8_t>(bits);
+        }
+        remaining_ = Cards;
+    }
+
+    // A uniformly random remaining slot, which is removed. The deck must not
+    // be empty.
+    template <random_engine URBG>
+    std::uint16_t draw(URBG&& rng) {
+        const std::uint16_t rank = static_cast<std::uint16_t>(bounded_random(rng, remaining_));
+        std::uint16_t slot;
+        bitset_deck_detail::take_ranked(words_.data(), counts_.data(), word_count, &rank, &slot, 1, select_);
+        --remaining_;
+        return slot;
+    }
+
+    // Fills out with out.size() slots drawn in order, at most remaining().
+    // Ranks are drawn several per random word, as in shuffle_prefix.
+    template <random_engine URBG>
+    void deal(std::span<std::uint16_t> out, URBG&& rng) {
+        constexpr std::size_t chunk = 64;
+        std::array<std::uint16_t, chunk + 3> ranks;
+        std::array<std::uint64_t, 4> offsets;
+        for (std::size_t first = 0; first < out.size(); first += chunk) {
+            const std::size_t wanted = std::min(chunk, out.size() - first);
+            for (std::size_t filled = 0; filled < wanted; ) {
+                const std::uint64_t range = remaining_ - filled;
+                if (range == 1) {
+                    ranks[filled++] = 0;
+                    continue;
+                }
+                const std::size_t drawn = shuffle_detail::draw_forward_steps(rng, range, offsets);
+                for (std::size_t k = 0; k < drawn; ++k) {
+                    ranks[filled++] = static_cast<std::uint16_t>(offsets[k]);
+                }
+            }
+            bitset_deck_detail::take_ranked(words_.data(), counts_.data(), word_count, ranks.data(), out.data() + first,
+                                            wanted, select_);
+            remaining_ -= static_cast<std::uint16_t>(wanted);
+        }
+    }
+
+private:
+    std::array<std::uint64_t, word_count> words_;
+    std::array<std::uint8_t, word_count> counts_;
+    std::uint16_t remaining_;
+    bit_select select_;
+};
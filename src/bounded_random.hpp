@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+// Unbiased bounded random integers built on Lemire's multiply-shift method
+// ("Fast Random Integer Generation in an Interval", 2019). The high half of
+// random * range is the result; the low half is only compared against the
+// range, and the division that computes the exact rejection threshold runs on
+// the rare draws whose low half is smaller than the range.
+
+// Returns 64 random bits, combining several calls for engines that produce
+// fewer bits per call (std::mt19937 yields 32).
+template <std::uniform_random_bit_generator URBG>
+std::uint64_t random_bits64(URBG& rng) {
+    using result_type = typename URBG::result_type;
+    static_assert(URBG::min() == 0, "engine must produce values starting at zero");
+    static_assert(std::has_single_bit(static_cast<std::uint64_t>(URBG::max()) + 1)
+                      || static_cast<std::uint64_t>(URBG::max()) == UINT64_MAX,
+                  "engine must produce a whole number of random bits");
+
+    constexpr int bits = std::bit_width(static_cast<std::uint64_t>(URBG::max()));
+    if constexpr (bits >= 64) {
+        return static_cast<std::uint64_t>(rng());
+    } else {
+        std::uint64_t value = 0;
+        for (int filled = 0; filled < 64; filled += bits) {
+            value = (value << bits) | static_cast<std::uint64_t>(static_cast<result_type>(rng()));
+        }
+        return value;
+    }
+}
+
+// Uniform integer in [0, range). range must be non-zero.
+template <std::uniform_random_bit_generator URBG>
+std::uint64_t bounded_random(URBG& rng, std::uint64_t range) {
+    unsigned __int128 product = static_cast<unsigned __int128>(random_bits64(rng)) * range;
+    std::uint64_t leftover = static_cast<std::uint64_t>(product);
+    if (leftover < range) {
+        std::uint64_t threshold = -range % range;
+        while (leftover < threshold) {
+            product = static_cast<unsigned __int128>(random_bits64(rng)) * range;
+            leftover = static_cast<std::uint64_t>(product);
+        }
+    }
+    return static_cast<std::uint64_t>(product >> 64);
+}
+
+// Draws K independent uniform integers, result[i] in [0, ranges[i]), from a
+// single 64-bit word (Brackett-Rozinsky and Lemire, "Batched Ranged Random
+// Integer Generation", 2024). Each range peels off the high half of a
+// multiplication and the low half feeds the next one, so the final low half
+// is random * product mod 2^64 and one rejection test covers the whole batch.
+// The product of the ranges must fit in 64 bits; keeping it well below 2^64
+// keeps rejections rare.
+template <std::size_t K, std::uniform_random_bit_generator URBG>
+std::array<std::uint64_t, K> bounded_random_batch(URBG& rng, const std::array<std::uint64_t, K>& ranges) {
+    std::uint64_t range_product = 1;
+    for (std::uint64_t range : ranges) {
+        range_product *= range;
+    }
+
+    std::array<std::uint64_t, K> result;
+    auto draw = [&] {
+        std::uint64_t leftover = random_bits64(rng);
+        for (std::size_t i = 0; i < K; ++i) {
+            unsigned __int128 product = static_cast<unsigned __int128>(leftover) * ranges[i];
+            result[i] = static_cast<std::uint64_t>(product >> 64);
+            leftover = static_cast<std::uint64_t>(product);
+        }
+        return leftover;
+    };
+
+    std::uint64_t leftover = draw();
+    if (leftover < range_product) {
+        std::uint64_t threshold = -range_product % range_product;
+        while (leftover < threshold) {
+            leftover = draw();
+        }
+    }
+    return result;
+}
+
+// Largest first range for which bounded_random_descending<K> keeps the
+// product of its K ranges at or below about 2^56, so at most one draw in 256
+// reaches the threshold division.
+template <std::size_t K>
+inline constexpr std::uint64_t max_batched_range = [] {
+    static_assert(K >= 1 && K <= 4);
+    constexpr std::array<std::uint64_t, 5> limits = {
+        0, UINT64_MAX, std::uint64_t{1} << 28, std::uint64_t{1} << 18, std::uint64_t{1} << 14,
+    };
+    return limits[K];
+}();
+
+// K draws with the shrinking ranges first_range, first_range - 1, ... that a
+// Fisher-Yates pass needs. first_range must be at least K.
+template <std::size_t K, std::uniform_random_bit_generator URBG>
+std::array<std::uint64_t, K> bounded_random_descending(URBG& rng, std::uint64_t first_range) {
+    std::array<std::uint64_t, K> ranges;
+    for (std::size_t i = 0; i < K; ++i) {
+        ranges[i] = first_range - i;
+    }
+    return bounded_random_batch(rng, ranges);
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "bounded_random.hpp"
+#include "shuffle.hpp"
+
+// Cache-conscious shuffle for arrays far larger than the last-level cache
+// (Rao-Sandelius). Every element gets a uniformly random bucket label and is
+// scattered into its bucket, keeping its relative order; each bucket is then
+// shuffled on its own while it fits in cache. Labels are independent and the
+// buckets are shuffled uniformly, so the result is a uniform permutation.
+//
+// The scatter reads the array once in order and appends to a few hundred
+// bucket tails, so nearly every access is sequential. Labels are not stored:
+// a copy of the engine counts them in a first pass and the real engine
+// replays the same labels while scattering. Buckets that are still too big
+// are split again recursively.
+
+// Bytes per bucket that comfortably fit in L2 on current cores.
+inline constexpr size_t bucket_shuffle_default_bytes = size_t{256} << 10;
+
+namespace shuffle_detail {
+    // At most 2^10 buckets per pass keeps the scatter's write streams within
+    // what the TLB and write-combining buffers can track.
+    inline constexpr int bucket_shuffle_max_bits = 10;
+
+    // Hands out bucket labels of label_bits bits, several per random word.
+    template <typename URBG>
+    class bucket_labels {
+    public:
+        bucket_labels(URBG& rng, int label_bits)
+            : rng_(rng), label_bits_(label_bits), labels_per_word_(64 / label_bits),
+              mask_((std::uint64_t{1} << label_bits) - 1) {}
+
+        size_t next() {
+            if (left_ == 0) {
+                word_ = random_bits64(rng_);
+                left_ = labels_per_word_;
+            }
+            const size_t label = word_ & mask_;
+            word_ >>= label_bits_;
+            --left_;
+            return label;
+        }
+
+    private:
+        URBG& rng_;
+        int label_bits_;
+        int labels_per_word_;
+        std::uint64_t mask_;
+        std::uint64_t word_ = 0;
+        int left_ = 0;
+    };
+}
+
+// A bucket_bytes of 0 means bucket_shuffle_default_bytes.
+template <typename T, random_engine URBG>
+void shuffle_bucketed(std::span<T> array, URBG&& rng, size_t bucket_bytes = bucket_shuffle_default_bytes) {
+    if (bucket_bytes == 0) bucket_bytes = bucket_shuffle_default_bytes;
+    const size_t n = array.size();
+    if (n <= 1 || n * sizeof(T) <= bucket_bytes) {
+        shuffle_fisher_yates(array, rng);
+        return;
+    }
+
+    using engine_type = std::remove_cvref_t<URBG>;
+    const size_t wanted_buckets = (n * sizeof(T) + bucket_bytes - 1) / bucket_bytes;
+    const int label_bits = std::min(static_cast<int>(std::bit_width(wanted_buckets - 1)), shuffle_detail::bucket_shuffle_max_bits);
+    const size_t bucket_count = size_t{1} << label_bits;
+
+    std::vector<size_t> bucket_starts(bucket_count + 1, 0);
+    {
+        engine_type counting_rng = rng;
+        shuffle_detail::bucket_labels<engine_type> labels(counting_rng, label_bits);
+        for (size_t i = 0; i < n; ++i) {
+            ++bucket_starts[labels.next() + 1];
+        }
+    }
+    for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+        bucket_starts[bucket + 1] += bucket_starts[bucket];
+    }
+
+    auto buffer = std::make_unique_for_overwrite<T[]>(n);
+    {
+        std::vector<size_t> tails(bucket_starts.begin(), bucket_starts.end() - 1);
+        shuffle_detail::bucket_labels<engine_type> labels(rng, label_bits);
+        for (size_t i = 0; i < n; ++i) {
+            buffer[tails[labels.next()]++] = std::move(array[i]);
+        }
+    }
+
+    // Shuffle each bucket while it is hot and move it straight back.
+    for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+        const size_t first = bucket_starts[bucket];
+        const size_t size = bucket_starts[bucket + 1] - first;
+        std::span<T> contents(buffer.get() + first, size);
+        shuffle_bucketed(contents, rng, bucket_bytes);
+        std::move(contents.begin(), contents.end(), array.begin() + first);
+    }
+}
+
+template <typename T>
+void shuffle_bucketed(std::span<T> array) {
+    shuffle_bucketed(array, get_rng());
+}
+
+template <shuffleable_range Range, random_engine URBG>
+void shuffle_bucketed(Range&& array, URBG&& rng, size_t bucket_bytes = bucket_shuffle_default_bytes) {
+    shuffle_bucketed(as_shuffle_span(array), rng, bucket_bytes);
+}
+
+template <shuffleable_range Range>
+void shuffle_bucketed(Range&& array) {
+    shuffle_bucketed(as_shuffle_span(array));
+}
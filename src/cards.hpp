@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "bounded_random.hpp"
+#include "partial_shuffle.hpp"
+#include "shuffle.hpp"
+
+// Compact playing cards. A card is one byte holding a 6-bit rank and suit
+// code, and a shoe keeps its cards inline with no heap allocation: a 52-card
+// deck fills exactly one 64-byte cache line, an eight-deck shoe seven,
+// against 208 and 1664 bytes for the same cards stored as int.
+
+enum class card_suit : std::uint8_t { clubs, diamonds, hearts, spades };
+
+class card {
+public:
+    static constexpr int ranks = 13;
+    static constexpr int suits = 4;
+
+    card() = default;
+
+    // rank is 0 (two) through 12 (ace).
+    constexpr card(int rank, card_suit suit) : code_(static_cast<std::uint8_t>(static_cast<int>(suit) << 4 | rank)) {}
+
+    constexpr int rank() const { return code_ & 0xf; }
+    constexpr card_suit suit() const { return static_cast<card_suit>(code_ >> 4); }
+
+    // Position in a new deck, 0 through 51: suit by suit, two to ace.
+    constexpr int index() const { return (code_ >> 4) * ranks + (code_ & 0xf); }
+
+    // The raw 6-bit code: suit in bits 4-5, rank in bits 0-3.
+    constexpr std::uint8_t code() const { return code_; }
+
+    friend constexpr bool operator==(card, card) = default;
+
+private:
+    std::uint8_t code_ = 0;
+};
+
+static_assert(sizeof(card) == 1);
+
+// DeckCount full decks in new-deck order. Dealing is lazy: each deal()
+// takes one forward Fisher-Yates step over the cards not dealt yet, so a
+// round that deals k cards costs O(k) whatever the shoe size, and the next
+// round may deal from where this one stopped or collect() the cards first.
+template <size_t DeckCount>
+class alignas(64) shoe {
+public:
+    static constexpr size_t capacity = 52 * DeckCount;
+    static_assert(DeckCount > 0 && capacity <= UINT16_MAX);
+
+    shoe() {
+        for (size_t i = 0; i < capacity; ++i) {
+            cards_[i] = card(static_cast<int>(i % card::ranks), static_cast<card_suit>(i / card::ranks % card::suits));
+        }
+    }
+
+    static constexpr size_t size() { return capacity; }
+    size_t dealt() const { return dealt_; }
+    size_t remaining() const { return capacity - dealt_; }
+    bool empty() const { return dealt_ == capacity; }
+
+    std::span<const card, capacity> cards() const { return cards_; }
+    std::span<const card> dealt_cards() const { return std::span<const card>(cards_).first(dealt_); }
+
+    // Puts every dealt card back; the next deals start a fresh shuffle.
+    void collect() { dealt_ = 0; }
+
+    // Full shuffle of all cards, which are collected first. Only needed
+    // when the whole order matters at once; dealing does not require it.
+    template <random_engine URBG>
+    void shuffle(URBG&& rng) {
+        shuffle_fisher_yates(std::span<card>(cards_), rng);
+        dealt_ = 0;
+    }
+
+    // Next card, uniform among those not dealt yet. The shoe must not be empty.
+    template <random_engine URBG>
+    card deal(URBG&& rng) {
+        const size_t range = capacity - dealt_;
+        const size_t position = dealt_ + static_cast<size_t>(bounded_random(rng, range));
+        std::swap(cards_[dealt_], cards_[position]);
+        return cards_[dealt_++];
+    }
+
+    // Deals min(count, remaining()) cards at once, drawing several swap
+    // offsets per random word, and returns them in deal order.
+    template <random_engine URBG>
+    std::span<const card> deal(size_t count, URBG&& rng) {
+        const size_t first = dealt_;
+        const size_t dealt = shuffle_prefix(std::span<card>(cards_).subspan(first), count, rng).size();
+        dealt_ += static_cast<std::uint16_t>(dealt);
+        return std::span<const card>(cards_).subspan(first, dealt);
+    }
+
+private:
+    std::array<card, capacity> cards_;
+    std::uint16_t dealt_ = 0;
+};
+
+using deck = shoe<1>;
+
+static_assert(sizeof(deck) == 64);
@@ -0,0 +1,33 @@
+#include "cpu_features.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_FEATURES_X86 1
+#endif
+
+bool simd_backend_supported(simd_backend backend) {
+    switch (backend) {
+        case simd_backend::scalar: return true;
+#ifdef CPU_FEATURES_X86
+        case simd_backend::avx2: return __builtin_cpu_supports("avx2");
+        case simd_backend::avx512: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+        default: return false;
+    }
+}
+
+simd_backend best_simd_backend() {
+    static const simd_backend best = [] {
+        if (simd_backend_supported(simd_backend::avx512)) return simd_backend::avx512;
+        if (simd_backend_supported(simd_backend::avx2)) return simd_backend::avx2;
+        return simd_backend::scalar;
+    }();
+    return best;
+}
+
+const char* simd_backend_name(simd_backend backend) {
+    switch (backend) {
+        case simd_backend::avx512: return "AVX-512";
+        case simd_backend::avx2: return "AVX2";
+        default: return "scalar";
+    }
+}
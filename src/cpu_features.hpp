@@ -0,0 +1,13 @@
+#pragma once
+
+// Instruction sets the vectorized code paths can use, detected at run time
+// so one binary runs everywhere. avx512 stands for AVX-512 F and BW, which
+// every AVX-512 desktop and server core has.
+enum class simd_backend { scalar, avx2, avx512 };
+
+// Widest backend the running CPU supports.
+simd_backend best_simd_backend();
+
+bool simd_backend_supported(simd_backend backend);
+
+const char* simd_backend_name(simd_backend backend);
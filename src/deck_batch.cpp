@@ -0,0 +1,149 @@
+#include "deck_batch.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DECK_BATCH_X86 1
+#endif
+
+namespace {
+    // Inlined into the target-specific wrappers below, where the compiler
+    // vectorizes it for the wider instruction set.
+    template <typename Word, typename Index>
+    [[gnu::always_inline]] inline bool step_indices(const Word* random, std::size_t width,
+                                                    std::uint32_t range, Index* indices) {
+        using Product = std::conditional_t<sizeof(Word) == 2, std::uint32_t, std::uint64_t>;
+        constexpr int bits = 8 * sizeof(Word);
+        Word any_low = 0;
+        for (std::size_t j = 0; j < width; ++j) {
+            const Product product = Product{random[j]} * range;
+            indices[j] = static_cast<Index>(product >> bits);
+            any_low |= static_cast<Word>(product) < range;
+        }
+        return any_low != 0;
+    }
+
+    // Lanes touch different decks, so the swaps are independent.
+    template <typename Index>
+    void swap_lanes(std::uint8_t* tile, std::size_t row_stride, std::size_t first, std::size_t width,
+                    std::size_t position, const Index* indices) {
+        std::uint8_t* row = tile + position * row_stride;
+        for (std::size_t j = first; j < width; ++j) {
+            std::uint8_t& other = tile[indices[j] * row_stride + j];
+            const std::uint8_t card = row[j];
+            row[j] = other;
+            other = card;
+        }
+    }
+
+#ifdef DECK_BATCH_X86
+    __attribute__((target("avx2"))) bool step_indices_avx2(
+            const std::uint16_t* random, std::size_t width, std::uint32_t range, std::uint8_t* indices) {
+        return step_indices(random, width, range, indices);
+    }
+
+    __attribute__((target("avx2"))) bool step_indices_avx2(
+            const std::uint32_t* random, std::size_t width, std::uint32_t range, std::uint32_t* indices) {
+        return step_indices(random, width, range, indices);
+    }
+
+    __attribute__((target("avx512f,avx512bw"))) bool step_indices_avx512(
+            const std::uint16_t* random, std::size_t width, std::uint32_t range, std::uint8_t* indices) {
+        return step_indices(random, width, range, indices);
+    }
+
+    __attribute__((target("avx512f,avx512bw"))) bool step_indices_avx512(
+            const std::uint32_t* random, std::size_t width, std::uint32_t range, std::uint32_t* indices) {
+        return step_indices(random, width, range, indices);
+    }
+
+    // SIMD has no byte gather or scatter, so the vector kernels sweep every
+    // row r below position instead: lanes whose index equals r exchange
+    // their card with the position row through a compare and two blends.
+    // The position row stays in a register for the whole sweep. Both return
+    // how many leading lanes they handled.
+
+    __attribute__((target("avx2"))) std::size_t blend_lanes_avx2(
+            std::uint8_t* tile, std::size_t row_stride, std::size_t width, std::size_t position,
+            const std::uint8_t* indices) {
+        constexpr std::size_t chunk = 32;
+        std::size_t first = 0;
+        for (; first + chunk <= width; first += chunk) {
+            const __m256i lane_index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + first));
+            __m256i* row = reinterpret_cast<__m256i*>(tile + position * row_stride + first);
+            __m256i card = _mm256_loadu_si256(row);
+            for (std::size_t r = 0; r < position; ++r) {
+                __m256i* other = reinterpret_cast<__m256i*>(tile + r * row_stride + first);
+                const __m256i other_card = _mm256_loadu_si256(other);
+                const __m256i hit = _mm256_cmpeq_epi8(lane_index, _mm256_set1_epi8(static_cast<char>(r)));
+                _mm256_storeu_si256(other, _mm256_blendv_epi8(other_card, card, hit));
+                card = _mm256_blendv_epi8(card, other_card, hit);
+            }
+            _mm256_storeu_si256(row, card);
+        }
+        return first;
+    }
+
+    __attribute__((target("avx512f,avx512bw"))) std::size_t blend_lanes_avx512(
+            std::uint8_t* tile, std::size_t row_stride, std::size_t width, std::size_t position,
+            const std::uint8_t* indices) {
+        constexpr std::size_t chunk = 64;
+        std::size_t first = 0;
+        for (; first + chunk <= width; first += chunk) {
+            const __m512i lane_index = _mm512_loadu_si512(indices + first);
+            std::uint8_t* row = tile + position * row_stride + first;
+            __m512i card = _mm512_loadu_si512(row);
+            for (std::size_t r = 0; r < position; ++r) {
+                std::uint8_t* other = tile + r * row_stride + first;
+                const __m512i other_card = _mm512_loadu_si512(other);
+                const __mmask64 hit = _mm512_cmpeq_epi8_mask(lane_index, _mm512_set1_epi8(static_cast<char>(r)));
+                _mm512_storeu_si512(other, _mm512_mask_blend_epi8(hit, other_card, card));
+                card = _mm512_mask_blend_epi8(hit, card, other_card);
+            }
+            _mm512_storeu_si512(row, card);
+        }
+        return first;
+    }
+#endif
+}
+
+namespace shuffle_detail {
+    bool deck_step_indices(const std::uint16_t* random, std::size_t width, std::uint32_t range,
+                           std::uint8_t* indices, simd_backend backend) {
+#ifdef DECK_BATCH_X86
+        if (backend == simd_backend::avx512) return step_indices_avx512(random, width, range, indices);
+        if (backend == simd_backend::avx2) return step_indices_avx2(random, width, range, indices);
+#endif
+        return step_indices(random, width, range, indices);
+    }
+
+    bool deck_step_indices(const std::uint32_t* random, std::size_t width, std::uint32_t range,
+                           std::uint32_t* indices, simd_backend backend) {
+#ifdef DECK_BATCH_X86
+        if (backend == simd_backend::avx512) return step_indices_avx512(random, width, range, indices);
+        if (backend == simd_backend::avx2) return step_indices_avx2(random, width, range, indices);
+#endif
+        return step_indices(random, width, range, indices);
+    }
+
+    void deck_step_swap(std::uint8_t* tile, std::size_t row_stride, std::size_t width,
+                        std::size_t position, const std::uint8_t* indices, simd_backend backend) {
+        std::size_t swapped = 0;
+#ifdef DECK_BATCH_X86
+        if (backend == simd_backend::avx512) {
+            swapped = blend_lanes_avx512(tile, row_stride, width, position, indices);
+        } else if (backend == simd_backend::avx2) {
+            swapped = blend_lanes_avx2(tile, row_stride, width, position, indices);
+        }
+#endif
+        swap_lanes(tile, row_stride, swapped, width, position, indices);
+    }
+
+    void deck_step_swap(std::uint8_t* tile, std::size_t row_stride, std::size_t width,
+                        std::size_t position, const std::uint32_t* indices) {
+        swap_lanes(tile, row_stride, 0, width, position, indices);
+    }
+}
+
+void shuffle_deck_block(std::span<std::uint8_t> cards, std::size_t deck_count) {
+    shuffle_deck_block(cards, deck_count, get_rng());
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <utility>
+
+#include "bounded_random.hpp"
+#include "random_engines.hpp"
+#include "shuffle.hpp"
+#include "simd_random.hpp"
+
+// Shuffles a whole block of small decks in one pass. The block is stored
+// position-major (structure of arrays): card p of deck d is
+// cards[p * deck_count + d]. One Fisher-Yates step then reads one random
+// word per deck and touches one contiguous row, so the index arithmetic runs
+// across SIMD lanes with lane j working on deck j. Decks are processed in
+// tiles narrow enough that a tile of every row stays in L1.
+//
+// The low positions, where most of a 52-card deck's steps are, draw 16-bit
+// words and, on AVX2 and AVX-512 machines, swap across lanes too; higher
+// positions draw 32-bit words and swap lane by lane.
+
+namespace shuffle_detail {
+    inline constexpr std::size_t deck_tile_width = 256;
+
+    // Highest position that takes the 16-bit, SIMD-swapped path. The vector
+    // swap sweeps every row below the position, so its cost grows with the
+    // position while the lane-by-lane swap costs the same everywhere.
+    inline constexpr std::size_t deck_blend_max_position = 96;
+
+    // indices[j] = random[j] * range >> 16 (or >> 32) for every lane.
+    // Returns true when some lane's low half fell below range, i.e. it may
+    // need to be redrawn.
+    bool deck_step_indices(const std::uint16_t* random, std::size_t width, std::uint32_t range,
+                           std::uint8_t* indices, simd_backend backend);
+    bool deck_step_indices(const std::uint32_t* random, std::size_t width, std::uint32_t range,
+                           std::uint32_t* indices, simd_backend backend);
+
+    // Swaps cards[position][j] with cards[indices[j]][j] for every lane of
+    // a tile whose rows are row_stride apart. indices[j] <= position.
+    void deck_step_swap(std::uint8_t* tile, std::size_t row_stride, std::size_t width,
+                        std::size_t position, const std::uint8_t* indices, simd_backend backend);
+    void deck_step_swap(std::uint8_t* tile, std::size_t row_stride, std::size_t width,
+                        std::size_t position, const std::uint32_t* indices);
+
+    // Fills count words of type Word, using the engine's bulk fill() when it
+    // has one. The 64-bit words are staged and copied out, so out may be any
+    // word type; it must have room for a whole number of 64-bit words.
+    template <typename Word, typename URBG>
+    void random_words(URBG& rng, Word* out, std::size_t count) {
+        constexpr std::size_t per_word = sizeof(std::uint64_t) / sizeof(Word);
+        constexpr std::size_t staged_words = 64;
+        const std::size_t words = (count + per_word - 1) / per_word;
+        std::array<std::uint64_t, staged_words> staged;
+        for (std::size_t first = 0; first < words; first += staged_words) {
+            const std::size_t chunk = std::min(staged_words, words - first);
+            if constexpr (requires { rng.fill(staged.data(), chunk); }) {
+                rng.fill(staged.data(), chunk);
+            } else {
+                for (std::size_t i = 0; i < chunk; ++i) {
+                    staged[i] = random_bits64(rng);
+                }
+            }
+            std::memcpy(out + first * per_word, staged.data(), chunk * sizeof(std::uint64_t));
+        }
+    }
+
+    // Redraws the lanes whose low half lies below the exact threshold
+    // 2^bits mod range, as in bounded_random.
+    template <typename Word, typename Index, typename URBG>
+    void fix_deck_step_indices(URBG& rng, const Word* random, std::size_t width,
+                               std::uint32_t range, Index* indices) {
+        constexpr int bits = 8 * sizeof(Word);
+        const Word threshold = static_cast<Word>(static_cast<Word>(0 - range) % range);
+        for (std::size_t j = 0; j < width; ++j) {
+            std::uint64_t product = std::uint64_t{random[j]} * range;
+            while (static_cast<Word>(product) < threshold) {
+                product = (random_bits64(rng) >> (64 - bits)) * range;
+            }
+            indices[j] = static_cast<Index>(product >> bits);
+        }
+    }
+}
+
+// Fisher-Yates shuffles each of the deck_count decks stored position-major
+// in cards, independently and uniformly. cards.size() must be a multiple of
+// deck_count. Positions whose range no longer fits in 32 bits, in decks of
+// more than 2^32 cards, are drawn lane by lane with bounded_random. Every
+// backend gives the same result for the same engine state; backend must be
+// supported by the CPU.
+template <random_engine URBG>
+void shuffle_deck_block(std::span<std::uint8_t> cards, std::size_t deck_count, URBG&& rng,
+                        simd_backend backend = best_simd_backend()) {
+    if (deck_count == 0) return;
+    const std::size_t deck_size = cards.size() / deck_count;
+    using shuffle_detail::deck_tile_width;
+
+    alignas(64) std::array<std::uint32_t, deck_tile_width> random32;
+    alignas(64) std::array<std::uint32_t, deck_tile_width> indices32;
+    alignas(64) std::array<std::uint16_t, deck_tile_width> random16;
+    alignas(64) std::array<std::uint8_t, deck_tile_width> indices8;
+
+    for (std::size_t first_deck = 0; first_deck < deck_count; first_deck += deck_tile_width) {
+        const std::size_t width = std::min(deck_tile_width, deck_count - first_deck);
+        std::uint8_t* tile = cards.data() + first_deck;
+        for (std::size_t position = deck_size - 1; position > 0; --position) {
+            if (position >= UINT32_MAX) {
+                for (std::size_t j = 0; j < width; ++j) {
+                    const std::uint64_t other = bounded_random(rng, std::uint64_t{position} + 1);
+                    std::swap(tile[position * deck_count + j], tile[other * deck_count + j]);
+                }
+                continue;
+            }
+            const auto range = static_cast<std::uint32_t>(position + 1);
+            if (position <= shuffle_detail::deck_blend_max_position) {
+                shuffle_detail::random_words(rng, random16.data(), width);
+                if (shuffle_detail::deck_step_indices(random16.data(), width, range, indices8.data(), backend)) {
+                    shuffle_detail::fix_deck_step_indices(rng, random16.data(), width, range, indices8.data());
+                }
+                shuffle_detail::deck_step_swap(tile, deck_count, width, position, indices8.data(), backend);
+            } else {
+                shuffle_detail::random_words(rng, random32.data(), width);
+                if (shuffle_detail::deck_step_indices(random32.data(), width, range, indices32.data(), backend)) {
+                    shuffle_detail::fix_deck_step_indices(rng, random32.data(), width, range, indices32.data());
+                }
+                shuffle_detail::deck_step_swap(tile, deck_count, width, position, indices32.data());
+            }
+        }
+    }
+}
+
+void shuffle_deck_block(std::span<std::uint8_t> cards, std::size_t deck_count);
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "bounded_random.hpp"
+#include "shuffle.hpp"
+
+// Direct generators for the two restricted shuffles the dealer rotations
+// need, instead of retrying Fisher-Yates until the result qualifies.
+//
+// shuffle_sattolo (Sattolo, 1986) is Fisher-Yates with the swap target
+// drawn from the positions strictly below the current one, which yields a
+// uniformly random permutation consisting of a single cycle: following
+// "the element now at i came from position p" visits every position.
+//
+// shuffle_derangement is the early-rejection algorithm of Martinez,
+// Panholzer and Prodinger ("Generating random derangements", 2008). It
+// runs Sattolo-like swaps from the top, and after each swap closes the
+// current cycle with exactly the probability that a uniform derangement of
+// the positions still open would close it there. Closed positions are
+// marked and skipped, and a draw that lands on one is rejected. The paper
+// bounds the expected draws by 2n; with only about ln n cycles to close,
+// rejections are rare in practice. Retrying Fisher-Yates instead needs
+// about e passes.
+
+namespace shuffle_detail {
+    // K Sattolo steps for the positions n - 1, ..., n - K, drawn from one
+    // random word: the ranges are n - 1, n - 2, ...
+    template <std::size_t K, typename T, typename URBG>
+    void sattolo_batch(std::span<T> array, size_t n, URBG& rng) {
+        auto random_indices = bounded_random_descending<K>(rng, n - 1);
+        for (size_t k = 0; k < K; ++k) {
+            std::swap(array[n - 1 - k], array[random_indices[k]]);
+        }
+    }
+
+    // D(u), the number of derangements of u elements, for u <= 34; D(35)
+    // no longer fits in 128 bits.
+    inline constexpr size_t derangement_exact_limit = 34;
+    inline constexpr std::array<unsigned __int128, derangement_exact_limit + 1> derangement_counts = [] {
+        std::array<unsigned __int128, derangement_exact_limit + 1> counts{1, 0};
+        for (size_t u = 2; u <= derangement_exact_limit; ++u) {
+            counts[u] = (u - 1) * (counts[u - 1] + counts[u - 2]);
+        }
+        return counts;
+    }();
+
+    // The chance (u - 1) D(u - 2) / D(u) as a 64-bit binary fraction and
+    // the remainder of the division: (u - 1) D(u - 2) 2^64 = fraction D(u)
+    // + rest. Certainty (u = 2) is written as fraction 2^64 - 1, rest D(u).
+    struct derangement_coin {
+        std::uint64_t fraction = 0;
+        unsigned __int128 rest = 0;
+    };
+
+    inline constexpr std::array<derangement_coin, derangement_exact_limit + 1> derangement_coins = [] {
+        std::array<derangement_coin, derangement_exact_limit + 1> coins{};
+        for (size_t u = 2; u <= derangement_exact_limit; ++u) {
+            const unsigned __int128 count = derangement_counts[u];
+            unsigned __int128 rest = (u - 1) * derangement_counts[u - 2];
+            if (rest == count) {
+                coins[u] = {UINT64_MAX, count};
+                continue;
+            }
+            std::uint64_t fraction = 0;
+            for (int bit = 0; bit < 64; ++bit) {
+                rest <<= 1;
+                fraction <<= 1;
+                if (rest >= count) {
+                    rest -= count;
+                    fraction |= 1;
+                }
+            }
+            coins[u] = {fraction, rest};
+        }
+        return coins;
+    }();
+
+    // Uniform integer below range by rejection on the bits of range - 1; at
+    // least half the draws are kept.
+    template <typename URBG>
+    unsigned __int128 bounded_random_wide(URBG& rng, unsigned __int128 range) {
+        const unsigned __int128 largest = range - 1;
+        const std::uint64_t high = static_cast<std::uint64_t>(largest >> 64);
+        const std::uint64_t low = static_cast<std::uint64_t>(largest);
+        const unsigned __int128 mask = high != 0
+            ? static_cast<unsigned __int128>(UINT64_MAX >> std::countl_zero(high)) << 64 | UINT64_MAX
+            : UINT64_MAX >> std::countl_zero(low | 1);
+        unsigned __int128 value;
+        do {
+            value = static_cast<unsigned __int128>(random_bits64(rng)) << 64 | random_bits64(rng);
+            value &= mask;
+        } while (value > largest);
+        return value;
+    }
+
+    // True with probability (u - 1) D(u - 2) / D(u): the chance that, with u
+    // positions still open, the swap just made closes its cycle. One random
+    // word compared with the coin's fraction decides it; only a word equal
+    // to the fraction, one draw in 2^64, needs the remainder. Exact for
+    // u <= 34; above that the coin is 1/u, which differs from the exact
+    // probability by less than 10^-38.
+    template <typename URBG>
+    bool derangement_closes_cycle(URBG& rng, size_t u) {
+        if (u <= derangement_exact_limit) {
+            const derangement_coin& coin = derangement_coins[u];
+            const std::uint64_t word = random_bits64(rng);
+            if (word != coin.fraction) [[likely]] return word < coin.fraction;
+            return bounded_random_wide(rng, derangement_counts[u]) < coin.rest;
+        }
+        return bounded_random(rng, u) == 0;
+    }
+}
+
+template <typename T, random_engine URBG>
+void shuffle_sattolo(std::span<T> array, URBG&& rng) {
+    // Same batch schedule as fisher_yates(), shifted down by one range.
+    size_t n = array.size();
+    while (n > 5) {
+        if (n - 1 > max_batched_range<2>) {
+            shuffle_detail::sattolo_batch<1>(array, n, rng);
+            n -= 1;
+        } else if (n - 1 > max_batched_range<3>) {
+            shuffle_detail::sattolo_batch<2>(array, n, rng);
+            n -= 2;
+        } else if (n - 1 > max_batched_range<4>) {
+            shuffle_detail::sattolo_batch<3>(array, n, rng);
+            n -= 3;
+        } else {
+            shuffle_detail::sattolo_batch<4>(array, n, rng);
+            n -= 4;
+        }
+    }
+    switch (n) {
+        case 5: shuffle_detail::sattolo_batch<3>(array, n, rng); break;
+        case 4: shuffle_detail::sattolo_batch<2>(array, n, rng); break;
+        case 3: shuffle_detail::sattolo_batch<1>(array, n, rng); break;
+    }
+    // The last step has a single choice.
+    if (array.size() >= 2) std::swap(array[1], array[0]);
+}
+
+template <typename T>
+void shuffle_sattolo(std::span<T> array) {
+    shuffle_sattolo(array, get_rng());
+}
+
+template <shuffleable_range Range, random_engine URBG>
+void shuffle_sattolo(Range&& array, URBG&& rng) {
+    shuffle_sattolo(as_shuffle_span(array), rng);
+}
+
+template <shuffleable_range Range>
+void shuffle_sattolo(Range&& array) {
+    shuffle_sattolo(as_shuffle_span(array));
+}
+
+// Uniformly random reordering in which no element stays at its position.
+// A single element has no derangement; it is left as it is.
+template <typename T, random_engine URBG>
+void shuffle_derangement(std::span<T> array, URBG&& rng) {
+    const size_t n = array.size();
+    if (n < 2) return;
+
+    // One bit per position whose cycle has been closed.
+    std::vector<std::uint64_t> marked((n + 63) / 64, 0);
+    std::uint64_t* const marks = marked.data();
+    auto is_marked = [marks](size_t position) { return (marks[position / 64] >> (position % 64)) & 1; };
+
+    size_t open = n;
+    for (size_t i = n - 1; open >= 2; --i) {
+        if (is_marked(i)) continue;
+        size_t j;
+        bool closes;
+        if (open > shuffle_detail::derangement_exact_limit && i <= max_batched_range<2>) {
+            // Swap target and the 1/open coin from one random word; a
+            // marked target redraws both.
+            std::array<std::uint64_t, 2> draws;
+            do {
+                draws = bounded_random_batch(rng, std::array<std::uint64_t, 2>{i, open});
+            } while (is_marked(draws[0]));
+            j = draws[0];
+            closes = draws[1] == 0;
+        } else {
+            do {
+                j = bounded_random(rng, i);
+            } while (is_marked(j));
+            closes = shuffle_detail::derangement_closes_cycle(rng, open);
+        }
+        std::swap(array[i], array[j]);
+        if (closes) {
+            marks[j / 64] |= std::uint64_t{1} << (j % 64);
+            --open;
+        }
+        --open;
+    }
+}
+
+template <typename T>
+void shuffle_derangement(std::span<T> array) {
+    shuffle_derangement(array, get_rng());
+}
+
+template <shuffleable_range Range, random_engine URBG>
+void shuffle_derangement(Range&& array, URBG&& rng) {
+    shuffle_derangement(as_shuffle_span(array), rng);
+}
+
+template <shuffleable_range Range>
+void shuffle_derangement(Range&& array) {
+    shuffle_derangement(as_shuffle_span(array));
+}
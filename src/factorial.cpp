@@ -1,3 +1,384 @@
+#include "factorial.hpp"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <utility>
+
+#include "parallel_for.hpp"
+
 int factorial( int number ) {
    return number <= 1 ? 1 : factorial( number - 1 ) * number;
 }
+
+namespace {
+    using limbs = std::vector<std::uint32_t>;
+    constexpr std::uint64_t base = factorial_limb_base;
+
+    // Karatsuba splits of at least this many limbs hand their three
+    // sub-products to separate threads.
+    constexpr std::size_t parallel_karatsuba_limbs = 2048;
+
+    // Factors multiplied one by one into a single number before the product
+    // tree takes over.
+    constexpr std::size_t product_tree_leaf = 32;
+
+    void trim(limbs& number) {
+        while (!number.empty() && number.back() == 0) {
+            number.pop_back();
+        }
+    }
+
+    // out[0, a.size() + b.size()) = a * b. Each row adds its products into
+    // 64-bit columns without carrying; a column holds 16 products of two
+    // limbs on top of a carried value, so the carries run every 16 rows.
+    void multiply_schoolbook(std::span<const std::uint32_t> a, std::span<const std::uint32_t> b, std::uint32_t* out) {
+        const std::size_t size = a.size() + b.size();
+        std::vector<std::uint64_t> columns(size, 0);
+        std::uint64_t* const column = columns.data();
+        auto carry_all = [&] {
+            std::uint64_t carry = 0;
+            for (std::size_t k = 0; k < size; ++k) {
+                const std::uint64_t value = column[k] + carry;
+                column[k] = value % base;
+                carry = value / base;
+            }
+        };
+        const std::uint32_t* const b_limbs = b.data();
+        const std::size_t b_size = b.size();
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            const std::uint64_t multiplier = a[i];
+            std::uint64_t* const row = column + i;
+            for (std::size_t j = 0; j < b_size; ++j) {
+                row[j] += multiplier * b_limbs[j];
+            }
+            if (i % 16 == 15) carry_all();
+        }
+        carry_all();
+        for (std::size_t k = 0; k < size; ++k) {
+            out[k] = static_cast<std::uint32_t>(column[k]);
+        }
+    }
+
+    limbs add(std::span<const std::uint32_t> a, std::span<const std::uint32_t> b) {
+        if (a.size() < b.size()) std::swap(a, b);
+        limbs sum(a.size() + 1);
+        std::uint32_t carry = 0;
+        for (std::size_t k = 0; k < a.size(); ++k) {
+            std::uint32_t value = a[k] + (k < b.size() ? b[k] : 0) + carry;
+            carry = value >= base;
+            sum[k] = carry ? value - static_cast<std::uint32_t>(base) : value;
+        }
+        sum[a.size()] = carry;
+        return sum;
+    }
+
+    // x -= y; x must be at least y.
+    void subtract(limbs& x, std::span<const std::uint32_t> y) {
+        std::uint32_t borrow = 0;
+        for (std::size_t k = 0; k < x.size() && (k < y.size() || borrow); ++k) {
+            const std::uint32_t take = (k < y.size() ? y[k] : 0) + borrow;
+            borrow = x[k] < take;
+            x[k] = borrow ? x[k] + static_cast<std::uint32_t>(base) - take : x[k] - take;
+        }
+    }
+
+    // out += x * base^offset; the sum must fit in out.
+    void add_at(limbs& out, std::span<const std::uint32_t> x, std::size_t offset) {
+        std::uint32_t carry = 0;
+        for (std::size_t k = offset; k < out.size() && (k - offset < x.size() || carry); ++k) {
+            std::uint32_t value = out[k] + (k - offset < x.size() ? x[k - offset] : 0) + carry;
+            carry = value >= base;
+            out[k] = carry ? value - static_cast<std::uint32_t>(base) : value;
+        }
+    }
+
+    // a * b in exactly a.size() + b.size() limbs.
+    limbs product(std::span<const std::uint32_t> a, std::span<const std::uint32_t> b, std::size_t thread_count) {
+        if (a.size() > b.size()) std::swap(a, b);
+        limbs out(a.size() + b.size(), 0);
+        if (a.empty()) return out;
+        if (a.size() < factorial_detail::karatsuba_limbs) {
+            multiply_schoolbook(a, b, out.data());
+            return out;
+        }
+        if (2 * a.size() <= b.size()) {
+            // Lopsided: multiply a by pieces of b as long as a.
+            for (std::size_t first = 0; first < b.size(); first += a.size()) {
+                limbs part = product(a, b.subspan(first, std::min(a.size(), b.size() - first)), thread_count);
+                trim(part);
+                add_at(out, part, first);
+            }
+            return out;
+        }
+
+        // a = a1 * base^m + a0 and likewise b; a1 is not empty because a is
+        // more than half as long as b.
+        const std::size_t m = b.size() / 2;
+        const limbs a_sum = add(a.first(m), a.subspan(m));
+        const limbs b_sum = add(b.first(m), b.subspan(m));
+        limbs low, middle, high;
+        auto sub_product = [&](std::size_t which, std::size_t threads) {
+            switch (which) {
+                case 0: low = product(a.first(m), b.first(m), threads); break;
+                case 1: middle = product(a_sum, b_sum, threads); break;
+                default: high = product(a.subspan(m), b.subspan(m), threads); break;
+            }
+        };
+        if (thread_count > 1 && a.size() >= parallel_karatsuba_limbs) {
+            const std::size_t threads = std::max<std::size_t>(1, thread_count / 3);
+            parallel_for(3, thread_count, [&](std::size_t which) { sub_product(which, threads); });
+        } else {
+            for (std::size_t which = 0; which < 3; ++which) {
+                sub_product(which, thread_count);
+            }
+        }
+        subtract(middle, low);
+        subtract(middle, high);
+        trim(low);
+        trim(middle);
+        trim(high);
+        add_at(out, low, 0);
+        add_at(out, middle, m);
+        add_at(out, high, 2 * m);
+        return out;
+    }
+
+    void multiply_small(limbs& number, std::uint32_t factor) {
+        std::uint64_t carry = 0;
+        for (std::uint32_t& limb : number) {
+            const std::uint64_t value = std::uint64_t{limb} * factor + carry;
+            limb = static_cast<std::uint32_t>(value % base);
+            carry = value / base;
+        }
+        while (carry != 0) {
+            number.push_back(static_cast<std::uint32_t>(carry % base));
+            carry /= base;
+        }
+    }
+
+    // Product of factors as a balanced tree; the two halves of each node
+    // split the threads between them.
+    limbs product_of(std::span<const std::uint32_t> factors, std::size_t thread_count) {
+        if (factors.size() <= product_tree_leaf) {
+            limbs result = {1};
+            for (std::uint32_t factor : factors) {
+                multiply_small(result, factor);
+            }
+            return result;
+        }
+        const std::size_t half = factors.size() / 2;
+        limbs left, right;
+        if (thread_count > 1) {
+            parallel_for(2, 2, [&](std::size_t side) {
+                if (side == 0) {
+                    left = product_of(factors.first(half), thread_count / 2);
+                } else {
+                    right = product_of(factors.subspan(half), thread_count - thread_count / 2);
+                }
+            });
+        } else {
+            left = product_of(factors.first(half), 1);
+            right = product_of(factors.subspan(half), 1);
+        }
+        return factorial_detail::multiply(left, right, thread_count);
+    }
+
+    std::vector<std::uint32_t> primes_up_to(std::uint32_t limit) {
+        std::vector<std::uint8_t> composite(std::size_t{limit} + 1, 0);
+        std::vector<std::uint32_t> primes;
+        for (std::uint64_t candidate = 2; candidate <= limit; ++candidate) {
+            if (composite[candidate]) continue;
+            primes.push_back(static_cast<std::uint32_t>(candidate));
+            for (std::uint64_t multiple = candidate * candidate; multiple <= limit; multiple += candidate) {
+                composite[multiple] = 1;
+            }
+        }
+        return primes;
+    }
+
+    // The prime powers whose product is swing(n) = n! / ((n/2)!)^2: p
+    // appears to the power sum over k of (n / p^k) mod 2, which keeps every
+    // power at or below n.
+    std::vector<std::uint32_t> swing_factors(std::uint32_t number, std::span<const std::uint32_t> primes) {
+        std::vector<std::uint32_t> factors;
+        for (std::uint32_t prime : primes) {
+            if (prime > number) break;
+            std::uint64_t power = 1;
+            for (std::uint32_t quotient = number / prime; quotient > 0; quotient /= prime) {
+                if (quotient & 1) power *= prime;
+            }
+            if (power > 1) factors.push_back(static_cast<std::uint32_t>(power));
+        }
+        return factors;
+    }
+
+    limbs prime_swing_factorial(std::uint32_t number, std::span<const std::uint32_t> primes, std::size_t thread_count) {
+        if (number < 2) return {1};
+        const limbs half = prime_swing_factorial(number / 2, primes, thread_count);
+        const limbs square = factorial_detail::multiply(half, half, thread_count);
+        return factorial_detail::multiply(square, product_of(swing_factors(number, primes), thread_count), thread_count);
+    }
+}
+
+std::vector<std::uint32_t> factorial_detail::multiply(std::span<const std::uint32_t> a, std::span<const std::uint32_t> b,
+                                                      std::size_t thread_count) {
+    limbs result = product(a, b, std::max<std::size_t>(1, thread_count));
+    trim(result);
+    return result;
+}
+
+std::string factorial_detail::to_decimal(std::span<const std::uint32_t> limbs) {
+    if (limbs.empty()) return "0";
+    std::string digits(limbs.size() * 9, '0');
+    char* const first = digits.data();
+    char* end = std::to_chars(first, first + 9, limbs.back()).ptr;
+    for (std::size_t k = limbs.size() - 1; k-- > 0; ) {
+        // Every lower limb is written as exactly nine digits.
+        char limb_digits[9];
+        char* limb_end = std::to_chars(limb_digits, limb_digits + 9, limbs[k]).ptr;
+        const std::size_t length = static_cast<std::size_t>(limb_end - limb_digits);
+        std::fill(end, end + 9 - length, '0');
+        std::copy(limb_digits, limb_end, end + 9 - length);
+        end += 9;
+    }
+    digits.resize(static_cast<std::size_t>(end - first));
+    return digits;
+}
+
+std::vector<std::uint32_t> factorial_limbs(std::uint32_t number, std::size_t thread_count) {
+    if (thread_count == 0) thread_count = default_thread_count();
+    const std::vector<std::uint32_t> primes = primes_up_to(number);
+    return prime_swing_factorial(number, primes, thread_count);
+}
+
+std::string factorial_decimal(std::uint32_t number, std::size_t thread_count) {
+    return factorial_detail::to_decimal(factorial_limbs(number, thread_count));
+}
+
+const std::array<double, factorial_detail::log_factorial_table_size> factorial_detail::log_factorial_table = [] {
+    std::array<double, log_factorial_table_size> table;
+    long double sum = 0.0L;
+    for (std::size_t n = 0; n < log_factorial_table_size; ++n) {
+        sum += n > 1 ? std::log(static_cast<long double>(n)) : 0.0L;
+        table[n] = static_cast<double>(sum);
+    }
+    return table;
+}();
+
+namespace {
+    constexpr std::uint64_t one_bits = 0x3ff0000000000000;
+    constexpr std::uint64_t two_to_52_bits = 0x4330000000000000;
+    constexpr double two_to_52 = 4503599627370496.0;
+
+    // ln x for 1 <= x < 2^52. x = 2^e m with m in [sqrt(1/2), sqrt(2)), and
+    // ln m = 2 atanh(s), s = (m - 1) / (m + 1), |s| < 0.1716, whose series
+    // to s^21 is exact to double precision. ln 2 is split so that e * ln2_high
+    // is exact.
+    [[gnu::always_inline]] inline double log_of(double x) {
+        constexpr double ln2_high = 6.93147180369123816490e-01;
+        constexpr double ln2_low = 1.90821492927058770002e-10;
+        const std::uint64_t bits = std::bit_cast<std::uint64_t>(x);
+        const std::uint64_t high_mantissa = (bits & 0x000fffffffffffff) > 0x6a09e667f3bcc ? 1 : 0;
+        const std::uint64_t exponent = (bits >> 52) + high_mantissa;
+        const double m = std::bit_cast<double>((bits & 0x000fffffffffffff) | (one_bits - (high_mantissa << 52)));
+        // exponent - 1023 as a double, without a 64-bit integer conversion.
+        const double e = std::bit_cast<double>(two_to_52_bits | exponent) - two_to_52 - 1023.0;
+
+        const double s = (m - 1.0) / (m + 1.0);
+        const double s2 = s * s;
+        double series = 1.0 / 21.0;
+        series = series * s2 + 1.0 / 19.0;
+        series = series * s2 + 1.0 / 17.0;
+        series = series * s2 + 1.0 / 15.0;
+        series = series * s2 + 1.0 / 13.0;
+        series = series * s2 + 1.0 / 11.0;
+        series = series * s2 + 1.0 / 9.0;
+        series = series * s2 + 1.0 / 7.0;
+        series = series * s2 + 1.0 / 5.0;
+        series = series * s2 + 1.0 / 3.0;
+        return e * ln2_high + (e * ln2_low + (2.0 * s + 2.0 * s * s2 * series));
+    }
+
+    // Table entry or Stirling series, both computed and blended with a
+    // mask: a branch would keep the loop from vectorizing.
+    [[gnu::always_inline]] inline double log_factorial_of(std::uint64_t number) {
+        using factorial_detail::log_factorial_table_size;
+        const double x = std::bit_cast<double>(two_to_52_bits | (number + 1)) - two_to_52;
+        const double inverse = 1.0 / x;
+        const double inverse_squared = inverse * inverse;
+        const double series = inverse * (1.0 / 12 - inverse_squared * (1.0 / 360 - inverse_squared * (1.0 / 1260
+            - inverse_squared * (1.0 / 1680))));
+        const double stirling = (x - 0.5) * log_of(x) - x + factorial_detail::half_log_two_pi + series;
+
+        const std::uint64_t small = std::uint64_t{0} - static_cast<std::uint64_t>(number < log_factorial_table_size);
+        const double exact = factorial_detail::log_factorial_table[number & small & (log_factorial_table_size - 1)];
+        return std::bit_cast<double>((std::bit_cast<std::uint64_t>(exact) & small)
+                                     | (std::bit_cast<std::uint64_t>(stirling) & ~small));
+    }
+
+    [[gnu::always_inline]] inline void log_factorials(const std::uint64_t* numbers, double* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = log_factorial_of(numbers[i]);
+        }
+    }
+
+    [[gnu::always_inline]] inline void log_chooses(const std::uint64_t* n, const std::uint64_t* k, double* out,
+                                                   std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = log_factorial_of(n[i]) - log_factorial_of(k[i]) - log_factorial_of(n[i] - k[i]);
+        }
+    }
+
+    // fp-contract is off so that no backend fuses a multiply-add the others
+    // round twice.
+    [[gnu::optimize("fp-contract=off")]] void log_factorials_scalar(const std::uint64_t* numbers, double* out,
+                                                                    std::size_t count) {
+        log_factorials(numbers, out, count);
+    }
+
+    [[gnu::optimize("fp-contract=off")]] void log_chooses_scalar(const std::uint64_t* n, const std::uint64_t* k,
+                                                                 double* out, std::size_t count) {
+        log_chooses(n, k, out, count);
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    [[gnu::optimize("fp-contract=off")]] __attribute__((target("avx2"))) void log_factorials_avx2(
+            const std::uint64_t* numbers, double* out, std::size_t count) {
+        log_factorials(numbers, out, count);
+    }
+
+    [[gnu::optimize("fp-contract=off")]] __attribute__((target("avx2"))) void log_chooses_avx2(
+            const std::uint64_t* n, const std::uint64_t* k, double* out, std::size_t count) {
+        log_chooses(n, k, out, count);
+    }
+
+    [[gnu::optimize("fp-contract=off")]] __attribute__((target("avx512f,avx512bw"))) void log_factorials_avx512(
+            const std::uint64_t* numbers, double* out, std::size_t count) {
+        log_factorials(numbers, out, count);
+    }
+
+    [[gnu::optimize("fp-contract=off")]] __attribute__((target("avx512f,avx512bw"))) void log_chooses_avx512(
+            const std::uint64_t* n, const std::uint64_t* k, double* out, std::size_t count) {
+        log_chooses(n, k, out, count);
+    }
+#define FACTORIAL_X86 1
+#endif
+}
+
+void log_factorial(std::span<const std::uint64_t> numbers, std::span<double> out, simd_backend backend) {
+#ifdef FACTORIAL_X86
+    if (backend == simd_backend::avx512) return log_factorials_avx512(numbers.data(), out.data(), numbers.size());
+    if (backend == simd_backend::avx2) return log_factorials_avx2(numbers.data(), out.data(), numbers.size());
+#endif
+    log_factorials_scalar(numbers.data(), out.data(), numbers.size());
+}
+
+void log_choose(std::span<const std::uint64_t> n, std::span<const std::uint64_t> k, std::span<double> out,
+                simd_backend backend) {
+#ifdef FACTORIAL_X86
+    if (backend == simd_backend::avx512) return log_chooses_avx512(n.data(), k.data(), out.data(), n.size());
+    if (backend == simd_backend::avx2) return log_chooses_avx2(n.data(), k.data(), out.data(), n.size());
+#endif
+    log_chooses_scalar(n.data(), k.data(), out.data(), n.size());
+}
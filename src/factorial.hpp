@@ -1 +1,122 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "cpu_features.hpp"
+
+// Recursive reference version; int holds n! only up to 12!.
 int factorial( int number );
+
+// Checked factorials read from constexpr tables: one bounds check and one
+// load, at compile time or at run time. 20! is the largest that fits in 64
+// bits and 34! the largest that fits in 128.
+
+enum class factorial_error { negative, overflow };
+
+inline constexpr int factorial_u64_max = 20;
+inline constexpr int factorial_u128_max = 34;
+
+namespace factorial_detail {
+    template <typename Unsigned, int Max>
+    inline constexpr std::array<Unsigned, Max + 1> table = [] {
+        std::array<Unsigned, Max + 1> values{1};
+        for (int n = 1; n <= Max; ++n) {
+            values[n] = values[n - 1] * static_cast<Unsigned>(n);
+        }
+        return values;
+    }();
+
+    template <typename Unsigned, int Max>
+    constexpr std::expected<Unsigned, factorial_error> lookup(int number) {
+        if (number < 0) return std::unexpected(factorial_error::negative);
+        if (number > Max) return std::unexpected(factorial_error::overflow);
+        return table<Unsigned, Max>[static_cast<std::size_t>(number)];
+    }
+}
+
+constexpr std::expected<std::uint64_t, factorial_error> factorial_u64(int number) {
+    return factorial_detail::lookup<std::uint64_t, factorial_u64_max>(number);
+}
+
+constexpr std::expected<unsigned __int128, factorial_error> factorial_u128(int number) {
+    return factorial_detail::lookup<unsigned __int128, factorial_u128_max>(number);
+}
+
+// Exact n! for any n, as base-10^9 limbs (least significant first, each
+// below factorial_limb_base) or in decimal. Uses Luschny's prime swing:
+// n! = ((n/2)!)^2 * swing(n), where swing(n) is the product of one prime
+// power of at most n per prime. The powers are multiplied in a balanced
+// product tree and the big products use Karatsuba above
+// factorial_detail::karatsuba_limbs limbs. Subtrees and the three Karatsuba
+// sub-products of large operands run on up to thread_count threads (0
+// means default_thread_count()).
+
+inline constexpr std::uint32_t factorial_limb_base = 1000000000;
+
+std::vector<std::uint32_t> factorial_limbs(std::uint32_t number, std::size_t thread_count = 0);
+
+std::string factorial_decimal(std::uint32_t number, std::size_t thread_count = 0);
+
+namespace factorial_detail {
+    // Below this many limbs in the shorter operand, multiply schoolbook.
+    inline constexpr std::size_t karatsuba_limbs = 40;
+
+    // Product of two base-10^9 numbers, without leading zero limbs.
+    std::vector<std::uint32_t> multiply(std::span<const std::uint32_t> a, std::span<const std::uint32_t> b,
+                                        std::size_t thread_count = 1);
+
+    std::string to_decimal(std::span<const std::uint32_t> limbs);
+}
+
+// ln(n!) in double precision, for probabilities over card counts. n below
+// log_factorial_table_size is read from a table of correctly rounded
+// values; larger n use the Stirling series for ln Gamma(n + 1) through the
+// 1/n^7 term, whose truncation error is below 10^-20 there. log_choose
+// subtracts three of them, so its absolute error is a few ulp of ln(n!).
+
+namespace factorial_detail {
+    inline constexpr std::size_t log_factorial_table_size = 256;
+
+    extern const std::array<double, log_factorial_table_size> log_factorial_table;
+
+    inline constexpr double half_log_two_pi = 0.91893853320467274178;
+
+    // ln Gamma(x) for x > log_factorial_table_size.
+    inline double stirling_log_gamma(double x) {
+        const double inverse = 1.0 / x;
+        const double inverse_squared = inverse * inverse;
+        const double series = inverse * (1.0 / 12 - inverse_squared * (1.0 / 360 - inverse_squared * (1.0 / 1260
+            - inverse_squared * (1.0 / 1680))));
+        return (x - 0.5) * std::log(x) - x + half_log_two_pi + series;
+    }
+}
+
+inline double log_factorial(std::uint64_t number) {
+    if (number < factorial_detail::log_factorial_table_size) {
+        return factorial_detail::log_factorial_table[number];
+    }
+    return factorial_detail::stirling_log_gamma(static_cast<double>(number) + 1.0);
+}
+
+// ln C(n, k); k must be at most n.
+inline double log_choose(std::uint64_t n, std::uint64_t k) {
+    return log_factorial(n) - log_factorial(k) - log_factorial(n - k);
+}
+
+// Batch versions: out[i] = log_factorial(numbers[i]) and
+// out[i] = log_choose(n[i], k[i]), with every input below 2^52. The loop
+// is branch-free with its own polynomial logarithm, so it vectorizes for
+// the chosen backend; all backends return identical values, which agree
+// with the scalar functions to within a few ulp.
+void log_factorial(std::span<const std::uint64_t> numbers, std::span<double> out,
+                   simd_backend backend = best_simd_backend());
+
+void log_choose(std::span<const std::uint64_t> n, std::span<const std::uint64_t> k, std::span<double> out,
+                simd_backend backend = best_simd_backend());
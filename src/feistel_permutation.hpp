@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "bounded_random.hpp"
+#include "random_engines.hpp"
+
+// Random-access pseudorandom permutation of [0, size): position i of the
+// shuffled order is computed on demand in O(1) time and memory, without
+// materializing anything, so index spaces far too large to shuffle (10^10
+// and up) can still be visited in random order or sampled without repeats.
+//
+// A balanced Feistel network over the smallest even number of bits that
+// covers size is a keyed bijection of [0, 4^h). Values that land outside
+// [0, size) are encrypted again (cycle walking) until they fall inside; the
+// domain is less than four times size, so a lookup takes under four rounds
+// of the network on average. Running the network backwards gives the
+// inverse the same way.
+//
+// The permutation is pseudorandom, not uniform over all size! orders: it is
+// one of at most 2^64 keyed permutations, fine for sampling and load spreading
+// but not a substitute for Fisher-Yates where exact uniformity matters.
+class feistel_permutation {
+public:
+    static constexpr int rounds = 6;
+
+    feistel_permutation(std::uint64_t size, std::uint64_t seed) : size_(size) {
+        const int bits = std::max(2, static_cast<int>(std::bit_width(size > 0 ? size - 1 : 0)));
+        half_bits_ = (bits + 1) / 2;
+        half_mask_ = (std::uint64_t{1} << half_bits_) - 1;
+        splitmix64 keys(seed);
+        for (auto& key : keys_) {
+            key = keys();
+        }
+    }
+
+    template <random_engine URBG>
+    feistel_permutation(std::uint64_t size, URBG&& rng) : feistel_permutation(size, random_bits64(rng)) {}
+
+    std::uint64_t size() const { return size_; }
+
+    // Value at position index of the shuffled order; index must be below size().
+    std::uint64_t operator()(std::uint64_t index) const {
+        do {
+            index = encrypt(index);
+        } while (index >= size_);
+        return index;
+    }
+
+    // Position of value, so that inverse((*this)(i)) == i.
+    std::uint64_t inverse(std::uint64_t value) const {
+        do {
+            value = decrypt(value);
+        } while (value >= size_);
+        return value;
+    }
+
+private:
+    // Keyed round function onto half_bits_ bits: two multiply-xorshift steps
+    // of the splitmix64 finalizer.
+    std::uint64_t round_function(std::uint64_t half, std::uint64_t key) const {
+        std::uint64_t z = (half ^ key) * 0xbf58476d1ce4e5b9;
+        z ^= z >> 31;
+        z *= 0x94d049bb133111eb;
+        return (z >> 32) & half_mask_;
+    }
+
+    std::uint64_t encrypt(std::uint64_t x) const {
+        std::uint64_t left = x >> half_bits_;
+        std::uint64_t right = x & half_mask_;
+        for (int round = 0; round < rounds; ++round) {
+            const std::uint64_t next = left ^ round_function(right, keys_[round]);
+            left = right;
+            right = next;
+        }
+        return (left << half_bits_) | right;
+    }
+
+    std::uint64_t decrypt(std::uint64_t x) const {
+        std::uint64_t left = x >> half_bits_;
+        std::uint64_t right = x & half_mask_;
+        for (int round = rounds - 1; round >= 0; --round) {
+            const std::uint64_t previous = right ^ round_function(left, keys_[round]);
+            right = left;
+            left = previous;
+        }
+        return (left << half_bits_) | right;
+    }
+
+    std::uint64_t size_;
+    int half_bits_;
+    std::uint64_t half_mask_;
+    std::array<std::uint64_t, rounds> keys_;
+};
@@ -0,0 +1,23 @@
+#include "multiset_sampler.hpp"
+
+multiset_sampler::multiset_sampler(std::span<const std::uint64_t> counts) : size_(counts.size()) {
+    std::vector<node> leaves((counts.size() + fanout - 1) / fanout + (counts.empty() ? 1 : 0));
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        leaves[i / fanout].sums[i % fanout] = counts[i];
+        total_ += counts[i];
+    }
+    levels_.push_back(std::move(leaves));
+
+    while (levels_.back().size() > 1) {
+        const std::vector<node>& below = levels_.back();
+        std::vector<node> level((below.size() + fanout - 1) / fanout);
+        for (std::size_t i = 0; i < below.size(); ++i) {
+            std::uint64_t sum = 0;
+            for (std::uint64_t child : below[i].sums) {
+                sum += child;
+            }
+            level[i / fanout].sums[i % fanout] = sum;
+        }
+        levels_.push_back(std::move(level));
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "bounded_random.hpp"
+#include "random_engines.hpp"
+
+// Draws from a multiset without replacement: item i is picked with
+// probability count(i) / total() and one copy of it is removed. Items are
+// kept in an 8-ary tree of sums: a node is one 64-byte cache line holding
+// the totals of its eight children, and leaves hold the counts. A draw walks
+// from the root to a leaf, touching one cache line per level and
+// decrementing the one sum it follows, so draw, add and remove all take
+// O(log8 n) cache misses whatever the counts are.
+class multiset_sampler {
+public:
+    static constexpr std::size_t fanout = 8;
+
+    explicit multiset_sampler(std::span<const std::uint64_t> counts);
+
+    std::size_t size() const { return size_; }
+    std::uint64_t total() const { return total_; }
+    bool empty() const { return total_ == 0; }
+    std::uint64_t count(std::size_t item) const { return levels_[0][item / fanout].sums[item % fanout]; }
+
+    // Adds delta copies of item; delta may be negative down to -count(item).
+    void add(std::size_t item, std::int64_t delta) {
+        std::size_t index = item;
+        for (auto& level : levels_) {
+            level[index / fanout].sums[index % fanout] += static_cast<std::uint64_t>(delta);
+            index /= fanout;
+        }
+        total_ += static_cast<std::uint64_t>(delta);
+    }
+
+    // Item holding the rank-th copy, counting copies in item order; rank
+    // must be below total(). With remove set, that copy is taken out on the
+    // way down.
+    std::size_t find(std::uint64_t rank, bool remove = false) {
+        std::size_t index = 0;
+        for (std::size_t level = levels_.size(); level-- > 0; ) {
+            node& n = levels_[level][index];
+            const std::size_t child = child_holding(n, rank);
+            n.sums[child] -= remove;
+            index = index * fanout + child;
+        }
+        total_ -= remove;
+        return index;
+    }
+
+    // A random item, weighted by count, which is removed. Must not be empty.
+    template <random_engine URBG>
+    std::size_t draw(URBG&& rng) {
+        return find(bounded_random(rng, total_), true);
+    }
+
+    // A random item, weighted by count, left in place. Must not be empty.
+    template <random_engine URBG>
+    std::size_t sample(URBG&& rng) {
+        return find(bounded_random(rng, total_));
+    }
+
+private:
+    struct alignas(64) node {
+        std::array<std::uint64_t, fanout> sums = {};
+    };
+
+    // Child whose range of ranks holds rank, and rank made relative to it.
+    // Counting the prefix sums at or below rank needs no branches, which a
+    // uniformly random rank would mispredict. (Storing the prefix sums in
+    // the node instead makes every update touch all eight slots, and
+    // measured about twice as slow.)
+    static std::size_t child_holding(const node& n, std::uint64_t& rank) {
+        std::size_t child = 0;
+        std::uint64_t before = 0;
+        std::uint64_t cumulative = 0;
+        for (std::size_t k = 0; k + 1 < fanout; ++k) {
+            cumulative += n.sums[k];
+            const bool past = rank >= cumulative;
+            child += past;
+            before = past ? cumulative : before;
+        }
+        rank -= before;
+        return child;
+    }
+
+    // levels_[0] holds the counts, the last level is the single root.
+    std::vector<std::vector<node>> levels_;
+    std::size_t size_;
+    std::uint64_t total_ = 0;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Number of threads the parallel algorithms use when the caller passes 0.
+inline std::size_t default_thread_count() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Runs task(i) for every i in [0, count) on up to thread_count threads (0
+// means default_thread_count()). Tasks are handed out one at a time, so
+// uneven tasks balance themselves; the calling thread takes part and the
+// call returns once every task has finished.
+template <typename Task>
+void parallel_for(std::size_t count, std::size_t thread_count, Task&& task) {
+    if (thread_count == 0) thread_count = default_thread_count();
+    thread_count = std::min(thread_count, count);
+
+    if (thread_count <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    auto worker = [&] {
+        for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+             i = next.fetch_add(1, std::memory_order_relaxed)) {
+            task(i);
+        }
+    };
+
+    std::vector<std::thread> helpers;
+    helpers.reserve(thread_count - 1);
+    for (std::size_t t = 1; t < thread_count; ++t) {
+        helpers.emplace_back(worker);
+    }
+    worker();
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "bounded_random.hpp"
+#include "parallel_for.hpp"
+#include "rng_streams.hpp"
+#include "shuffle.hpp"
+
+// Multi-core shuffle in the style of MergeShuffle (Bacher, Bodini, Hollender
+// and Lumbroso, 2015): the array is cut into power-of-two many blocks that
+// are Fisher-Yates shuffled independently, then neighbouring blocks are
+// merged pairwise, level by level, with a random merge that keeps the result
+// uniform. Every block and every merge draws from its own stream, so the
+// output depends only on the seed and the array size, never on the number of
+// threads.
+
+// Merges the uniformly shuffled halves [0, split) and [split, size) into a
+// uniform shuffle of the whole span. A random bit picks the side of each
+// output position until one side runs out; the remaining positions are
+// fixed up with Fisher-Yates insertions, which take O(sqrt(size)) expected
+// steps.
+template <typename T, random_engine URBG>
+void merge_shuffled(std::span<T> array, size_t split, URBG&& rng) {
+    const size_t n = array.size();
+    size_t i = 0;
+    size_t j = split;
+
+    std::uint64_t bits = 0;
+    int bits_left = 0;
+
+    // While both sides still have elements the step needs no bounds checks,
+    // and the coin flip picks the source indices with a mask instead of a
+    // branch that would be mispredicted half the time.
+    while (i < j && j < n) {
+        if (bits_left == 0) {
+            bits = random_bits64(rng);
+            bits_left = 64;
+        }
+        const bool take_second = bits & 1;
+        bits >>= 1;
+        --bits_left;
+
+        const size_t swap_mask = (i ^ j) & (size_t{0} - take_second);
+        T first = std::move(array[i ^ swap_mask]);
+        T second = std::move(array[j ^ swap_mask]);
+        array[i] = std::move(first);
+        array[j] = std::move(second);
+        j += take_second;
+        ++i;
+    }
+
+    while (true) {
+        if (bits_left == 0) {
+            bits = random_bits64(rng);
+            bits_left = 64;
+        }
+        const bool take_second = bits & 1;
+        bits >>= 1;
+        --bits_left;
+
+        if (take_second) {
+            if (j == n) break;
+            std::swap(array[i], array[j]);
+            ++j;
+        } else if (i == j) {
+            break;
+        }
+        ++i;
+    }
+
+    for (; i < n; ++i) {
+        std::swap(array[i], array[bounded_random(rng, i + 1)]);
+    }
+}
+
+namespace shuffle_detail {
+    // Blocks of at least 64K elements stay cheap to shuffle from L2, and 1024
+    // of them are enough to keep any realistic core count busy.
+    inline constexpr size_t merge_shuffle_min_block = size_t{1} << 16;
+    inline constexpr size_t merge_shuffle_max_blocks = 1024;
+
+    inline size_t merge_shuffle_block_count(size_t size) {
+        return std::min(std::bit_floor(std::max<size_t>(1, size / merge_shuffle_min_block)),
+                        merge_shuffle_max_blocks);
+    }
+}
+
+template <typename T>
+void shuffle_parallel(std::span<T> array, const rng_stream_manager& streams, size_t thread_count = 0) {
+    const size_t n = array.size();
+    const size_t blocks = shuffle_detail::merge_shuffle_block_count(n);
+    // Streams 0 .. blocks - 1 shuffle the blocks, the rest drive the merges.
+    std::vector<default_engine> engines = streams.streams(2 * blocks - 1);
+    auto block_start = [&](size_t block) { return block * n / blocks; };
+
+    parallel_for(blocks, thread_count, [&](size_t block) {
+        const size_t first = block_start(block);
+        shuffle_fisher_yates(array.subspan(first, block_start(block + 1) - first), engines[block]);
+    });
+
+    size_t next_engine = blocks;
+    for (size_t width = 1; width < blocks; width *= 2) {
+        const size_t merges = blocks / (2 * width);
+        parallel_for(merges, thread_count, [&](size_t merge) {
+            const size_t first = block_start(2 * merge * width);
+            const size_t middle = block_start((2 * merge + 1) * width);
+            const size_t last = block_start((2 * merge + 2) * width);
+            merge_shuffled(array.subspan(first, last - first), middle - first, engines[next_engine + merge]);
+        });
+        next_engine += merges;
+    }
+}
+
+// Seeds the streams from the calling thread's get_rng() engine.
+template <typename T>
+void shuffle_parallel(std::span<T> array, size_t thread_count = 0) {
+    shuffle_parallel(array, rng_stream_manager(random_bits64(get_rng())), thread_count);
+}
+
+template <shuffleable_range Range>
+void shuffle_parallel(Range&& array, const rng_stream_manager& streams, size_t thread_count = 0) {
+    shuffle_parallel(as_shuffle_span(array), streams, thread_count);
+}
+
+template <shuffleable_range Range>
+void shuffle_parallel(Range&& array, size_t thread_count = 0) {
+    shuffle_parallel(as_shuffle_span(array), thread_count);
+}
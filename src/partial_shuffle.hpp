@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+#include "bounded_random.hpp"
+#include "shuffle.hpp"
+
+// Shuffles that only randomize the cards that are actually dealt. Both run
+// Fisher-Yates forwards: step i swaps position i with a uniform position in
+// [i, size), so after k steps the first k positions hold a uniform random
+// draw of k cards in uniform order, whatever the rest of the deck looks
+// like. Nothing past the dealt prefix is touched, so dealing k cards costs
+// O(k) regardless of the shoe size, and a later deal can continue from
+// there or restart from position 0 without reordering the deck first.
+
+namespace shuffle_detail {
+    // Draws the swap offsets of the next forward steps, whose ranges are
+    // range, range - 1, ... Batches follow the same limits as
+    // fisher_yates() and stop before the range reaches 1, where no draw is
+    // needed. Returns how many offsets were written; range must be at least 2.
+    template <typename URBG>
+    size_t draw_forward_steps(URBG& rng, std::uint64_t range, std::array<std::uint64_t, 4>& offsets) {
+        if (range > 4 && range <= max_batched_range<4>) {
+            offsets = bounded_random_descending<4>(rng, range);
+            return 4;
+        }
+        auto store = [&](const auto& batch) {
+            std::copy(batch.begin(), batch.end(), offsets.begin());
+            return batch.size();
+        };
+        if (range > max_batched_range<2> || range == 2) return store(bounded_random_descending<1>(rng, range));
+        if (range > max_batched_range<3> || range == 3) return store(bounded_random_descending<2>(rng, range));
+        return store(bounded_random_descending<3>(rng, range));
+    }
+
+    // K forward steps starting at position first, drawn from one random word.
+    template <std::size_t K, typename T, typename URBG>
+    void forward_fisher_yates_batch(std::span<T> array, size_t first, URBG& rng) {
+        auto offsets = bounded_random_descending<K>(rng, array.size() - first);
+        for (size_t k = 0; k < K; ++k) {
+            std::swap(array[first + k], array[first + k + offsets[k]]);
+        }
+    }
+}
+
+// Randomizes the first min(k, size) positions in O(k) and returns them.
+// Deals the same cards as a deal_cursor over the same deck and engine.
+template <typename T, random_engine URBG>
+std::span<T> shuffle_prefix(std::span<T> array, size_t k, URBG&& rng) {
+    const size_t n = array.size();
+    k = std::min(k, n);
+    const size_t last_step = std::min(k, n > 0 ? n - 1 : 0);
+
+    // Whole batches go through the unrolled steps; the batch that crosses
+    // last_step still draws all of its offsets, as the cursor would.
+    size_t i = 0;
+    while (i < last_step) {
+        const std::uint64_t range = n - i;
+        const size_t left = last_step - i;
+        if (range > max_batched_range<2> || range == 2) {
+            shuffle_detail::forward_fisher_yates_batch<1>(array, i, rng);
+            i += 1;
+        } else if ((range > max_batched_range<3> || range == 3) && left >= 2) {
+            shuffle_detail::forward_fisher_yates_batch<2>(array, i, rng);
+            i += 2;
+        } else if ((range > max_batched_range<4> || range == 4) && left >= 3) {
+            shuffle_detail::forward_fisher_yates_batch<3>(array, i, rng);
+            i += 3;
+        } else if (range > 4 && left >= 4) {
+            shuffle_detail::forward_fisher_yates_batch<4>(array, i, rng);
+            i += 4;
+        } else {
+            std::array<std::uint64_t, 4> offsets;
+            shuffle_detail::draw_forward_steps(rng, range, offsets);
+            for (size_t c = 0; c < left; ++c, ++i) {
+                std::swap(array[i], array[i + offsets[c]]);
+            }
+        }
+    }
+    return array.first(k);
+}
+
+template <typename T>
+std::span<T> shuffle_prefix(std::span<T> array, size_t k) {
+    return shuffle_prefix(array, k, get_rng());
+}
+
+template <shuffleable_range Range, random_engine URBG>
+auto shuffle_prefix(Range&& array, size_t k, URBG&& rng) {
+    return shuffle_prefix(as_shuffle_span(array), k, rng);
+}
+
+template <shuffleable_range Range>
+auto shuffle_prefix(Range&& array, size_t k) {
+    return shuffle_prefix(as_shuffle_span(array), k);
+}
+
+// Deals a deck one card at a time, extending the shuffled prefix on demand.
+// The deck and the engine must outlive the cursor. Swap offsets are drawn a
+// batch at a time and used in order, so the cards dealt equal those of
+// shuffle_prefix with the same engine state.
+template <typename T, random_engine URBG>
+class deal_cursor {
+public:
+    deal_cursor(std::span<T> deck, URBG& rng) : deck_(deck), rng_(rng) {}
+
+    template <shuffleable_range Range>
+    deal_cursor(Range&& deck, URBG& rng) : deal_cursor(as_shuffle_span(deck), rng) {}
+
+    bool empty() const { return dealt_ == deck_.size(); }
+    size_t dealt() const { return dealt_; }
+    size_t remaining() const { return deck_.size() - dealt_; }
+    std::span<T> dealt_cards() const { return deck_.first(dealt_); }
+
+    // Next card, uniform among those not dealt yet. The cursor must not be empty.
+    T& deal() {
+        const size_t range = deck_.size() - dealt_;
+        if (range > 1) {
+            if (next_offset_ == offset_count_) {
+                refill(range);
+            }
+            std::swap(deck_[dealt_], deck_[dealt_ + offsets_[next_offset_++]]);
+        }
+        return deck_[dealt_++];
+    }
+
+    // Puts every card back; the next deal starts a fresh shuffle from the
+    // deck's current order.
+    void reshuffle() {
+        dealt_ = 0;
+        offset_count_ = 0;
+        next_offset_ = 0;
+    }
+
+private:
+    // Out of line, so the per-card path stays a handful of instructions.
+    [[gnu::noinline]] void refill(size_t range) {
+        offset_count_ = shuffle_detail::draw_forward_steps(rng_, range, offsets_);
+        next_offset_ = 0;
+    }
+
+    std::span<T> deck_;
+    URBG& rng_;
+    size_t dealt_ = 0;
+    std::array<std::uint64_t, 4> offsets_;
+    size_t offset_count_ = 0;
+    size_t next_offset_ = 0;
+};
+
+template <shuffleable_range Range, typename URBG>
+deal_cursor(Range&&, URBG&) -> deal_cursor<std::remove_reference_t<std::ranges::range_reference_t<Range>>, URBG>;
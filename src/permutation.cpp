@@ -0,0 +1,68 @@
+#include "permutation.hpp"
+
+permutation::permutation(std::size_t size) : indices_(checked_size(size)) {
+    for (std::size_t i = 0; i < size; ++i) {
+        indices_[i] = static_cast<std::uint32_t>(i);
+    }
+    build_plan();
+}
+
+permutation::permutation(std::vector<std::uint32_t> indices) : indices_(std::move(indices)) {
+    checked_size(indices_.size());
+    build_plan();
+}
+
+std::size_t permutation::checked_size(std::size_t size) {
+    if (size > permutation_max_size) {
+        throw std::length_error("permutation: more than 2^32 - 1 positions");
+    }
+    return size;
+}
+
+permutation permutation::inverse() const {
+    std::vector<std::uint32_t> inverted(size());
+    for (std::size_t i = 0; i < size(); ++i) {
+        inverted[indices_[i]] = static_cast<std::uint32_t>(i);
+    }
+    return permutation(std::move(inverted));
+}
+
+permutation permutation::compose(const permutation& then) const {
+    std::vector<std::uint32_t> composed(size());
+    for (std::size_t i = 0; i < size(); ++i) {
+        composed[i] = indices_[then.indices_[i]];
+    }
+    return permutation(std::move(composed));
+}
+
+void permutation::build_plan() {
+    const std::size_t n = indices_.size();
+    block_bits_ = std::max(permutation_block_bits,
+                           static_cast<int>(std::bit_width(n)) - permutation_max_block_count_bits);
+    const std::size_t blocks = (n + block_elements() - 1) >> block_bits_;
+    sources_by_block_.clear();
+    block_starts_.clear();
+    if (blocks <= 1) return;
+
+    block_starts_.assign(blocks + 1, 0);
+    for (std::uint32_t source : indices_) {
+        ++block_starts_[(source >> block_bits_) + 1];
+    }
+    for (std::size_t block = 0; block < blocks; ++block) {
+        block_starts_[block + 1] += block_starts_[block];
+    }
+    sources_by_block_.resize(n);
+    std::vector<std::size_t> cursors(block_starts_.begin(), block_starts_.end() - 1);
+    for (std::uint32_t source : indices_) {
+        sources_by_block_[cursors[source >> block_bits_]++] = source;
+    }
+}
+
+std::vector<std::uint64_t> permutation::unvisited_bitmap() const {
+    const std::size_t n = size();
+    std::vector<std::uint64_t> visited((n + 63) / 64, 0);
+    if (n % 64 != 0) {
+        visited.back() = UINT64_MAX << (n % 64);
+    }
+    return visited;
+}
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "random_engines.hpp"
+#include "shuffle.hpp"
+
+// A permutation of 0 .. size - 1 that can be applied to any number of
+// columns. Applying it gathers: position i of the result takes the element
+// at position p[i]. Fisher-Yates swaps do not depend on the data, so a
+// permutation drawn with an engine rearranges every column exactly as
+// shuffling that column with a copy of the engine would.
+//
+// Gathers and scatters over columns that spill out of cache run in two
+// passes through a staging buffer. The source positions are grouped by
+// block of block_elements() positions once, when the permutation is built;
+// the first pass then works through the source one cache-sized block at a
+// time, and the second walks the destination in order, pulling from one
+// sequential stream per block. Every random access stays inside a block.
+//
+// In-place application either stages through the same buffer or, when
+// memory is tight, follows the cycles of the permutation with a bitmap of
+// the positions already placed.
+//
+// Positions are stored in 32 bits, so a permutation has at most
+// permutation_max_size elements; the constructors throw std::length_error
+// for more, as std::vector does for sizes beyond its max_size().
+
+// Columns at most this big are gathered directly; their random accesses
+// hit the cache anyway.
+inline constexpr std::size_t permutation_blocked_min_bytes = std::size_t{1} << 21;
+
+// 32K positions per block, 256 KiB of 8-byte elements: comfortably in L2.
+inline constexpr int permutation_block_bits = 15;
+
+// At most 2^10 blocks, so the second pass reads at most 1024 streams.
+inline constexpr int permutation_max_block_count_bits = 10;
+
+inline constexpr std::size_t permutation_max_size = UINT32_MAX;
+
+class permutation {
+public:
+    // The identity.
+    explicit permutation(std::size_t size = 0);
+
+    // indices[i] is the position that position i takes its element from; it
+    // must hold each of 0 .. indices.size() - 1 exactly once.
+    explicit permutation(std::vector<std::uint32_t> indices);
+
+    // A uniformly random permutation: shuffle_fisher_yates of the identity.
+    template <random_engine URBG>
+    permutation(std::size_t size, URBG&& rng) : indices_(checked_size(size)) {
+        for (std::size_t i = 0; i < size; ++i) {
+            indices_[i] = static_cast<std::uint32_t>(i);
+        }
+        shuffle_fisher_yates(std::span(indices_), rng);
+        build_plan();
+    }
+
+    std::size_t size() const { return indices_.size(); }
+    std::uint32_t operator[](std::size_t i) const { return indices_[i]; }
+    std::span<const std::uint32_t> indices() const { return indices_; }
+
+    // Positions per block of the two-pass gather and scatter.
+    std::size_t block_elements() const { return std::size_t{1} << block_bits_; }
+
+    permutation inverse() const;
+
+    // Applying the result is applying this permutation, then then:
+    // result[i] = (*this)[then[i]]. Both must have the same size.
+    permutation compose(const permutation& then) const;
+
+    // out[i] = in[p[i]]. in and out must not overlap.
+    template <typename T>
+    void apply(std::span<const T> in, std::span<T> out) const {
+        if (blocked(sizeof(T))) {
+            gather_blocked(in.data(), out.data());
+        } else {
+            gather_direct(in.data(), out.data());
+        }
+    }
+
+    // out[p[i]] = in[i], undoing apply. in and out must not overlap.
+    template <typename T>
+    void apply_inverse(std::span<const T> in, std::span<T> out) const {
+        if (blocked(sizeof(T))) {
+            scatter_blocked(in.data(), out.data());
+        } else {
+            scatter_direct(in.data(), out.data());
+        }
+    }
+
+    // apply in place, through a staging buffer of size() elements. The
+    // two-pass path reads all of data before writing any of it, so it needs
+    // no other copy.
+    template <typename T>
+    void apply(std::span<T> data) const {
+        if (blocked(sizeof(T))) {
+            gather_blocked(data.data(), data.data());
+            return;
+        }
+        auto staged = std::make_unique_for_overwrite<T[]>(size());
+        std::move(data.begin(), data.end(), staged.get());
+        gather_direct(staged.get(), data.data());
+    }
+
+    template <typename T>
+    void apply_inverse(std::span<T> data) const {
+        if (blocked(sizeof(T))) {
+            scatter_blocked(data.data(), data.data());
+            return;
+        }
+        auto staged = std::make_unique_for_overwrite<T[]>(size());
+        std::move(data.begin(), data.end(), staged.get());
+        scatter_direct(staged.get(), data.data());
+    }
+
+    // apply in place with one bit of extra memory per element: each cycle
+    // is walked from its lowest position, and a bitmap records the
+    // positions already placed. Every step waits for the index it follows,
+    // so once the column spills out of cache this is latency bound, more
+    // than ten times slower than apply; use it when the staging buffer does
+    // not fit.
+    template <typename T>
+    void apply_by_cycles(std::span<T> data) const {
+        std::vector<std::uint64_t> visited = unvisited_bitmap();
+        const std::uint32_t* const p = indices_.data();
+        for_each_cycle_start(visited, [&](std::size_t start) {
+            std::size_t j = start;
+            std::size_t k = p[start];
+            if (k == start) return;
+            T carried = std::move(data[start]);
+            while (k != start) {
+                data[j] = std::move(data[k]);
+                visited[k / 64] |= std::uint64_t{1} << (k % 64);
+                j = k;
+                k = p[k];
+            }
+            data[j] = std::move(carried);
+        });
+    }
+
+    template <typename T>
+    void apply_inverse_by_cycles(std::span<T> data) const {
+        std::vector<std::uint64_t> visited = unvisited_bitmap();
+        const std::uint32_t* const p = indices_.data();
+        for_each_cycle_start(visited, [&](std::size_t start) {
+            std::size_t k = p[start];
+            if (k == start) return;
+            T carried = std::move(data[start]);
+            while (k != start) {
+                std::swap(carried, data[k]);
+                visited[k / 64] |= std::uint64_t{1} << (k % 64);
+                k = p[k];
+            }
+            data[start] = std::move(carried);
+        });
+    }
+
+    template <shuffleable_range Range>
+    void apply(Range&& data) const {
+        apply(as_shuffle_span(data));
+    }
+
+    template <shuffleable_range Range>
+    void apply_inverse(Range&& data) const {
+        apply_inverse(as_shuffle_span(data));
+    }
+
+    template <shuffleable_range Range>
+    void apply_by_cycles(Range&& data) const {
+        apply_by_cycles(as_shuffle_span(data));
+    }
+
+    template <shuffleable_range Range>
+    void apply_inverse_by_cycles(Range&& data) const {
+        apply_inverse_by_cycles(as_shuffle_span(data));
+    }
+
+private:
+    // size, or std::length_error if it exceeds permutation_max_size.
+    static std::size_t checked_size(std::size_t size);
+
+    // Groups the source positions by block for the two-pass paths.
+    void build_plan();
+
+    bool blocked(std::size_t element_bytes) const {
+        return !sources_by_block_.empty() && size() * element_bytes > permutation_blocked_min_bytes;
+    }
+
+    // The gathers and scatters move from in when it is mutable and copy
+    // when it is const.
+    template <typename In, typename T>
+    void gather_direct(In* in, T* out) const {
+        const std::uint32_t* const p = indices_.data();
+        const std::size_t n = size();
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = std::move(in[p[i]]);
+        }
+    }
+
+    template <typename In, typename T>
+    void scatter_direct(In* in, T* out) const {
+        const std::uint32_t* const p = indices_.data();
+        const std::size_t n = size();
+        for (std::size_t i = 0; i < n; ++i) {
+            out[p[i]] = std::move(in[i]);
+        }
+    }
+
+    // Pass one reads in block by block, pass two writes out in order. in
+    // may be out.
+    template <typename In, typename T>
+    void gather_blocked(In* in, T* out) const {
+        const std::size_t n = size();
+        auto staged = std::make_unique_for_overwrite<T[]>(n);
+        const std::uint32_t* const sources = sources_by_block_.data();
+        for (std::size_t k = 0; k < n; ++k) {
+            staged[k] = std::move(in[sources[k]]);
+        }
+        std::vector<std::size_t> cursors(block_starts_.begin(), block_starts_.end() - 1);
+        std::size_t* const cursor = cursors.data();
+        const std::uint32_t* const p = indices_.data();
+        const int shift = block_bits_;
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = std::move(staged[cursor[p[i] >> shift]++]);
+        }
+    }
+
+    // Pass one reads in in order, pass two writes out block by block. in
+    // may be out.
+    template <typename In, typename T>
+    void scatter_blocked(In* in, T* out) const {
+        const std::size_t n = size();
+        auto staged = std::make_unique_for_overwrite<T[]>(n);
+        std::vector<std::size_t> cursors(block_starts_.begin(), block_starts_.end() - 1);
+        std::size_t* const cursor = cursors.data();
+        const std::uint32_t* const p = indices_.data();
+        const int shift = block_bits_;
+        for (std::size_t i = 0; i < n; ++i) {
+            staged[cursor[p[i] >> shift]++] = std::move(in[i]);
+        }
+        const std::uint32_t* const sources = sources_by_block_.data();
+        for (std::size_t k = 0; k < n; ++k) {
+            out[sources[k]] = std::move(staged[k]);
+        }
+    }
+
+    // One bit per position; the bits past size() start out set.
+    std::vector<std::uint64_t> unvisited_bitmap() const;
+
+    // Calls visit(start) with the lowest position whose bit is clear, after
+    // setting that bit, until every bit is set. visit marks the rest of the
+    // cycle; a whole word of placed positions is skipped at once.
+    template <typename Visit>
+    static void for_each_cycle_start(std::vector<std::uint64_t>& visited, Visit&& visit) {
+        for (std::size_t word = 0; word < visited.size(); ++word) {
+            while (visited[word] != UINT64_MAX) {
+                const int bit = std::countr_one(visited[word]);
+                visited[word] |= std::uint64_t{1} << bit;
+                visit(word * 64 + static_cast<std::size_t>(bit));
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> indices_;
+    int block_bits_ = permutation_block_bits;
+    // Source positions grouped by block, in destination order within a
+    // block, and where each block's group starts. Empty for one block.
+    std::vector<std::uint32_t> sources_by_block_;
+    std::vector<std::size_t> block_starts_;
+};
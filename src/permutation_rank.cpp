@@ -0,0 +1,128 @@
+#include "permutation_rank.hpp"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PERMUTATION_RANK_X86 1
+#endif
+
+namespace {
+    using namespace permutation_rank_detail;
+
+    // Digit i is the number of values still unused that are below perm[i];
+    // a chunk's digits are gathered Horner-style before the 256-bit rank
+    // takes them in one multiply-add.
+    [[gnu::always_inline]] inline uint256 rank_chunks(std::span<const std::uint8_t> perm) {
+        const std::size_t n = perm.size();
+        const rank_plan& plan = rank_plans[n];
+        std::uint64_t unused = (std::uint64_t{1} << n) - 1;
+        uint256 rank;
+        for (std::size_t c = 0; c < plan.chunk_count; ++c) {
+            const rank_chunk& chunk = plan.chunks[c];
+            std::uint64_t value = 0;
+            for (std::size_t i = chunk.first; i < chunk.first + chunk.size; ++i) {
+                const std::uint64_t bit = std::uint64_t{1} << perm[i];
+                value = value * (n - i) + static_cast<std::uint64_t>(std::popcount(unused & (bit - 1)));
+                unused ^= bit;
+            }
+            multiply_add(rank, chunk.radix, value);
+        }
+        return rank;
+    }
+
+    uint256 rank_portable(std::span<const std::uint8_t> perm) {
+        return rank_chunks(perm);
+    }
+
+#ifdef PERMUTATION_RANK_X86
+    // Any CPU with BMI2 has POPCNT.
+    __attribute__((target("popcnt"))) uint256 rank_popcnt(std::span<const std::uint8_t> perm) {
+        return rank_chunks(perm);
+    }
+
+    // Position i takes the digits[i]-th smallest value still unused. The
+    // unused mask stays in a register, where bitset_deck's take_ranked
+    // has to reload it after every count update.
+    __attribute__((target("bmi,bmi2"))) void select_values_bmi2(
+            const std::uint16_t* digits, std::span<std::uint8_t> perm) {
+        std::uint64_t unused = (std::uint64_t{1} << perm.size()) - 1;
+        for (std::size_t i = 0; i < perm.size(); ++i) {
+            const std::uint64_t bit = _pdep_u64(std::uint64_t{1} << digits[i], unused);
+            unused ^= bit;
+            perm[i] = static_cast<std::uint8_t>(_tzcnt_u64(bit));
+        }
+    }
+#endif
+}
+
+std::string to_string(const uint256& value) {
+    constexpr std::uint64_t group = 10000000000000000000u;
+    constexpr reciprocal group_reciprocal = make_reciprocal(group);
+    uint256 rest = value;
+    std::string digits;
+    do {
+        std::uint64_t low = divide(rest, group_reciprocal);
+        const bool last = rest == uint256{};
+        for (int d = 0; d < 19 && (!last || low != 0); ++d) {
+            digits.push_back(static_cast<char>('0' + low % 10));
+            low /= 10;
+        }
+    } while (rest != uint256{});
+    if (digits.empty()) digits.push_back('0');
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+uint256 permutation_rank(std::span<const std::uint8_t> perm, bit_select select) {
+#ifdef PERMUTATION_RANK_X86
+    if (select == bit_select::bmi2) return rank_popcnt(perm);
+#endif
+    return rank_portable(perm);
+}
+
+void permutation_unrank(const uint256& rank, std::span<std::uint8_t> perm, bit_select select) {
+    const std::size_t n = perm.size();
+    if (n == 0) return;
+    const rank_plan& plan = rank_plans[n];
+
+    // Chunks come out least significant first. Within a chunk, the digits
+    // are read most significant first from the 64-bit fraction
+    // ceil(value * 2^64 / radix): each is the integer part of the fraction
+    // times its radix, whose fractional part carries on exactly. Rounding up
+    // leaves the fraction above value / radix by less than 2^-64 < 1 / radix,
+    // too little for any later digit to cross a boundary, so every digit is
+    // exact and costs one multiply instead of a division.
+    //
+    // What is left of the rank shrinks by a word every chunk or so, and the
+    // first chunk's value is all that is left once the others are out.
+    std::array<std::uint16_t, permutation_rank_max_size> digits;
+    uint256 rest = rank;
+    std::size_t words = plan.random_words;
+    for (std::size_t c = plan.chunk_count; c-- > 0; ) {
+        const rank_chunk& chunk = plan.chunks[c];
+        std::uint64_t value = rest.words[0];
+        if (c > 0) {
+            value = divide(rest, chunk.radix_reciprocal, words);
+            while (words > 1 && rest.words[words - 1] == 0) --words;
+        }
+        std::uint64_t remainder = value << chunk.radix_reciprocal.shift;
+        std::uint64_t fraction = divide_step(remainder, 0, chunk.radix_reciprocal) + (remainder != 0);
+        for (std::size_t i = chunk.first; i < chunk.first + chunk.size; ++i) {
+            const unsigned __int128 product = static_cast<unsigned __int128>(fraction) * (n - i);
+            digits[i] = static_cast<std::uint16_t>(product >> 64);
+            fraction = static_cast<std::uint64_t>(product);
+        }
+    }
+
+#ifdef PERMUTATION_RANK_X86
+    if (select == bit_select::bmi2) {
+        select_values_bmi2(digits.data(), perm);
+        return;
+    }
+#endif
+    std::uint64_t unused = (std::uint64_t{1} << n) - 1;
+    std::uint8_t count = static_cast<std::uint8_t>(n);
+    std::array<std::uint16_t, permutation_rank_max_size> values;
+    bitset_deck_detail::take_ranked(&unused, &count, 1, digits.data(), values.data(), n, select);
+    std::copy_n(values.begin(), n, perm.begin());
+}
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "bitset_deck.hpp"
+#include "bounded_random.hpp"
+#include "factorial.hpp"
+#include "random_engines.hpp"
+#include "shuffle.hpp"
+
+// Ranking and unranking permutations of 0 .. n - 1 in lexicographic order,
+// so that a dealt deck is fingerprinted by a single integer in [0, n!).
+//
+// The rank is the Lehmer code read as a number in the factorial number
+// system: digit i counts the values after position i that are smaller
+// than perm[i], and has radix n - i. With at most 57 elements (57! is the
+// last factorial below 2^256) the values still unused fit in one 64-bit
+// mask, so each digit is one POPCNT of the mask below perm[i] when
+// ranking, and one select of the digit-th set bit when unranking; no tree
+// of counts is needed.
+//
+// Consecutive digits are gathered into 64-bit chunks whose radices
+// multiply to less than 2^64, about ten per chunk, so the 256-bit rank
+// takes one multiply-add or one division per chunk rather than per digit.
+// Those divisions use precomputed reciprocals (Moller and Granlund,
+// "Improved division by invariant integers", 2011), and the digits of a
+// chunk are read off a fixed-point fraction by multiplication, so
+// unranking runs no divide instruction.
+
+// Unsigned 256-bit integer, least significant word first.
+struct uint256 {
+    std::array<std::uint64_t, 4> words{};
+
+    constexpr uint256() = default;
+    constexpr uint256(std::uint64_t value) : words{value, 0, 0, 0} {}
+
+    friend constexpr bool operator==(const uint256&, const uint256&) = default;
+
+    friend constexpr std::strong_ordering operator<=>(const uint256& a, const uint256& b) {
+        for (std::size_t w = 4; w-- > 0; ) {
+            if (a.words[w] != b.words[w]) return a.words[w] <=> b.words[w];
+        }
+        return std::strong_ordering::equal;
+    }
+};
+
+// Decimal digits of value.
+std::string to_string(const uint256& value);
+
+inline constexpr std::size_t permutation_rank_max_size = 57;
+
+namespace permutation_rank_detail {
+    // A divisor shifted left until its top bit is set, and
+    // floor((2^128 - 1) / divisor) - 2^64.
+    struct reciprocal {
+        std::uint64_t divisor = 0;
+        std::uint64_t inverse = 0;
+        int shift = 0;
+    };
+
+    constexpr reciprocal make_reciprocal(std::uint64_t divisor) {
+        const int shift = std::countl_zero(divisor);
+        const std::uint64_t normalized = divisor << shift;
+        return {normalized, static_cast<std::uint64_t>(~static_cast<unsigned __int128>(0) / normalized), shift};
+    }
+
+    // Divides high * 2^64 + low by r.divisor, which must exceed high.
+    // Returns the quotient and leaves the remainder in high.
+    constexpr std::uint64_t divide_step(std::uint64_t& high, std::uint64_t low, const reciprocal& r) {
+        const unsigned __int128 estimate = static_cast<unsigned __int128>(r.inverse) * high
+            + (static_cast<unsigned __int128>(high) << 64 | low);
+        std::uint64_t quotient = static_cast<std::uint64_t>(estimate >> 64) + 1;
+        std::uint64_t remainder = low - quotient * r.divisor;
+        // Taken about half the time, so a mask instead of a branch.
+        const std::uint64_t over = -static_cast<std::uint64_t>(remainder > static_cast<std::uint64_t>(estimate));
+        quotient += over;
+        remainder += r.divisor & over;
+        if (remainder >= r.divisor) [[unlikely]] {
+            ++quotient;
+            remainder -= r.divisor;
+        }
+        high = remainder;
+        return quotient;
+    }
+
+    // The bits of value that shifting left by shift pushes out of the word.
+    constexpr std::uint64_t spill(std::uint64_t value, int shift) {
+        return (value >> 1) >> (63 - shift);
+    }
+
+    // value /= divisor; returns value % divisor. Only the low words words
+    // of value may be non-zero.
+    constexpr std::uint64_t divide(uint256& value, const reciprocal& r, std::size_t words = 4) {
+        std::uint64_t remainder = spill(value.words[words - 1], r.shift);
+        for (std::size_t w = words; w-- > 0; ) {
+            const std::uint64_t below = w > 0 ? spill(value.words[w - 1], r.shift) : 0;
+            value.words[w] = divide_step(remainder, value.words[w] << r.shift | below, r);
+        }
+        return remainder >> r.shift;
+    }
+
+    // value = value * factor + addend; the result must fit.
+    constexpr void multiply_add(uint256& value, std::uint64_t factor, std::uint64_t addend) {
+        std::uint64_t carry = addend;
+        for (std::uint64_t& word : value.words) {
+            const unsigned __int128 product = static_cast<unsigned __int128>(word) * factor + carry;
+            word = static_cast<std::uint64_t>(product);
+            carry = static_cast<std::uint64_t>(product >> 64);
+        }
+    }
+
+    inline constexpr auto factorials = [] {
+        std::array<uint256, permutation_rank_max_size + 1> table;
+        table[0] = 1;
+        for (std::size_t n = 1; n <= permutation_rank_max_size; ++n) {
+            table[n] = table[n - 1];
+            multiply_add(table[n], n, 0);
+        }
+        return table;
+    }();
+
+    // Positions first .. first + size - 1 of the Lehmer code, whose radices
+    // multiply to radix.
+    struct rank_chunk {
+        std::uint8_t first = 0;
+        std::uint8_t size = 0;
+        std::uint64_t radix = 1;
+        reciprocal radix_reciprocal;
+    };
+
+    // Every chunk but the last holds radices multiplying to more than
+    // 2^64 / 57 > 2^58, so six cover the 252 bits of 57!.
+    inline constexpr std::size_t max_rank_chunks = 6;
+
+    // How an n-element permutation splits into chunks, and what a uniform
+    // random rank below n! is drawn from: random_words words, the top one
+    // masked with top_mask.
+    struct rank_plan {
+        std::array<rank_chunk, max_rank_chunks> chunks{};
+        std::size_t chunk_count = 0;
+        std::size_t random_words = 0;
+        std::uint64_t top_mask = 0;
+    };
+
+    inline constexpr auto rank_plans = [] {
+        std::array<rank_plan, permutation_rank_max_size + 1> plans{};
+        for (std::size_t n = 1; n <= permutation_rank_max_size; ++n) {
+            rank_plan& plan = plans[n];
+            rank_chunk chunk;
+            for (std::size_t i = 0; i < n; ++i) {
+                std::uint64_t widened;
+                if (__builtin_mul_overflow(chunk.radix, n - i, &widened)) {
+                    plan.chunks[plan.chunk_count++] = chunk;
+                    chunk = {static_cast<std::uint8_t>(i), 0, 1, {}};
+                    widened = n - i;
+                }
+                chunk.radix = widened;
+                ++chunk.size;
+            }
+            plan.chunks[plan.chunk_count++] = chunk;
+            for (std::size_t c = 0; c < plan.chunk_count; ++c) {
+                plan.chunks[c].radix_reciprocal = make_reciprocal(plan.chunks[c].radix);
+            }
+
+            uint256 largest = factorials[n];
+            for (std::size_t w = 0; w < 4 && largest.words[w]-- == 0; ++w) {}
+            std::size_t bits = 0;
+            for (std::size_t w = 0; w < 4; ++w) {
+                if (largest.words[w] != 0) bits = 64 * w + std::bit_width(largest.words[w]);
+            }
+            plan.random_words = (bits + 63) / 64;
+            plan.top_mask = bits % 64 == 0 ? UINT64_MAX : (std::uint64_t{1} << (bits % 64)) - 1;
+        }
+        return plans;
+    }();
+
+    // Uniform integer in [0, n!) by rejection on the bits of n! - 1; at
+    // least half the draws are kept.
+    template <typename URBG>
+    uint256 random_rank(std::size_t n, URBG& rng) {
+        const rank_plan& plan = rank_plans[n];
+        uint256 rank;
+        do {
+            for (std::size_t w = 0; w < plan.random_words; ++w) {
+                rank.words[w] = random_bits64(rng);
+            }
+            if (plan.random_words > 0) rank.words[plan.random_words - 1] &= plan.top_mask;
+        } while (rank >= factorials[n]);
+        return rank;
+    }
+
+    // data[i] = old data[order[i]]. Trivially copyable elements go through
+    // a copy on the stack; others follow each cycle once, with a bit per
+    // position recording those already placed.
+    template <typename T>
+    void gather(std::span<T> data, const std::uint8_t* order) {
+        if constexpr (std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>) {
+            std::array<T, permutation_rank_max_size> staged;
+            std::copy(data.begin(), data.end(), staged.begin());
+            for (std::size_t i = 0; i < data.size(); ++i) {
+                data[i] = staged[order[i]];
+            }
+            return;
+        }
+        std::uint64_t placed = 0;
+        for (std::size_t start = 0; start < data.size(); ++start) {
+            if (placed >> start & 1) continue;
+            std::size_t j = start;
+            std::size_t k = order[start];
+            if (k == start) continue;
+            T carried = std::move(data[start]);
+            while (k != start) {
+                data[j] = std::move(data[k]);
+                placed |= std::uint64_t{1} << k;
+                j = k;
+                k = order[k];
+            }
+            data[j] = std::move(carried);
+        }
+    }
+}
+
+// n! for n <= permutation_rank_max_size.
+constexpr std::expected<uint256, factorial_error> factorial_u256(int n) {
+    if (n < 0) return std::unexpected(factorial_error::negative);
+    if (static_cast<std::size_t>(n) > permutation_rank_max_size) return std::unexpected(factorial_error::overflow);
+    return permutation_rank_detail::factorials[static_cast<std::size_t>(n)];
+}
+
+// Lexicographic rank of perm among the permutations of its size: 0 for
+// the identity, n! - 1 for the reversal. perm must hold each of
+// 0 .. perm.size() - 1 exactly once, and perm.size() must be at most
+// permutation_rank_max_size. A deck of cards ranks by card::index().
+uint256 permutation_rank(std::span<const std::uint8_t> perm, bit_select select = best_bit_select());
+
+// The permutation of perm.size() elements whose rank is rank, which must
+// be below perm.size()!.
+void permutation_unrank(const uint256& rank, std::span<std::uint8_t> perm, bit_select select = best_bit_select());
+
+// Uniformly random reordering of at most permutation_rank_max_size
+// elements, made by unranking a uniform random rank: 226 random bits for
+// 52 cards, redrawn when they reach 52!. The reordering gathers, as
+// permutation::apply does: position i takes the element at position
+// perm[i].
+template <typename T, random_engine URBG>
+void shuffle_by_unrank(std::span<T> array, URBG&& rng) {
+    if (array.size() < 2) return;
+    std::array<std::uint8_t, permutation_rank_max_size> order;
+    const std::span<std::uint8_t> perm(order.data(), array.size());
+    permutation_unrank(permutation_rank_detail::random_rank(array.size(), rng), perm);
+    permutation_rank_detail::gather(array, order.data());
+}
+
+template <typename T>
+void shuffle_by_unrank(std::span<T> array) {
+    shuffle_by_unrank(array, get_rng());
+}
+
+template <shuffleable_range Range, random_engine URBG>
+void shuffle_by_unrank(Range&& array, URBG&& rng) {
+    shuffle_by_unrank(as_shuffle_span(array), rng);
+}
+
+template <shuffleable_range Range>
+void shuffle_by_unrank(Range&& array) {
+    shuffle_by_unrank(as_shuffle_span(array));
+}
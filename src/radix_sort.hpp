@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "parallel_for.hpp"
+
+// Parallel radix sort of 64-bit records by their bits low_bit .. 63.
+//
+// Scattering into 256 buckets of a DRAM-sized array costs far more per
+// record than doing it inside L2, so only the first pass runs over the
+// whole array: it splits the records by their top bits into buckets of
+// about radix_sort_bucket_records records, in parallel. Each bucket is
+// then sorted on its own, in cache, with stable LSD passes of one byte,
+// and the buckets are spread over the threads.
+
+// Parts smaller than this are not worth a thread of their own.
+inline constexpr std::size_t radix_sort_min_part = std::size_t{1} << 16;
+
+// 16K records, 128 KiB per bucket and as much again for its buffer.
+inline constexpr std::size_t radix_sort_bucket_records = std::size_t{1} << 14;
+
+// At most 2^11 buckets, so the scatter's write streams stay manageable.
+inline constexpr int radix_sort_max_split_bits = 11;
+
+// Number of buckets radix_sort_by_high_bits splits size records into.
+inline std::size_t radix_sort_bucket_count(std::size_t size, int low_bit) {
+    const int split_bits = std::min({static_cast<int>(std::bit_width(size / radix_sort_bucket_records)),
+                                     radix_sort_max_split_bits, 64 - low_bit});
+    return std::size_t{1} << split_bits;
+}
+
+namespace radix_sort_detail {
+    // Stable counting sort of from into to by the digit (record >> shift) & mask.
+    inline void counting_pass(std::span<const std::uint64_t> from, std::span<std::uint64_t> to,
+                              int shift, std::uint64_t mask, std::vector<std::size_t>& offsets) {
+        offsets.assign(mask + 1, 0);
+        for (std::uint64_t record : from) {
+            ++offsets[(record >> shift) & mask];
+        }
+        std::size_t offset = 0;
+        for (std::size_t& count : offsets) {
+            offset += std::exchange(count, offset);
+        }
+        // A local pointer: the record stores could alias the offsets vector.
+        std::size_t* next = offsets.data();
+        std::uint64_t* out = to.data();
+        for (std::uint64_t record : from) {
+            out[next[(record >> shift) & mask]++] = record;
+        }
+    }
+}
+
+// Sorts records by bits low_bit .. 63 and calls
+// finish(sorted_bucket, bucket_index, first) once per bucket, in parallel,
+// while the bucket is still in cache; first is the bucket's offset in the
+// sorted order and sorted_bucket lives in either records or buffer. The
+// buckets split the records by their top bits, so records with equal sort
+// keys always share a bucket. buffer must be as large as records. The
+// bucket layout and the result do not depend on thread_count (0 means
+// default_thread_count()).
+template <typename Finish>
+void radix_sort_by_high_bits(std::span<std::uint64_t> records, std::span<std::uint64_t> buffer, int low_bit,
+                             std::size_t thread_count, Finish&& finish) {
+    if (thread_count == 0) thread_count = default_thread_count();
+    const std::size_t n = records.size();
+    const std::size_t bucket_count = radix_sort_bucket_count(n, low_bit);
+    const int split_bits = std::countr_zero(bucket_count);
+
+    std::vector<std::size_t> bucket_starts(bucket_count + 1, 0);
+    std::span<std::uint64_t> split = records;
+    std::span<std::uint64_t> spare = buffer;
+    if (split_bits > 0) {
+        const int shift = 64 - split_bits;
+        const std::size_t parts = std::clamp<std::size_t>(n / radix_sort_min_part, 1, thread_count);
+        auto part_start = [&](std::size_t part) { return part * n / parts; };
+
+        std::vector<std::vector<std::size_t>> offsets(parts, std::vector<std::size_t>(bucket_count));
+        parallel_for(parts, parts, [&](std::size_t part) {
+            std::size_t* counts = offsets[part].data();
+            const std::size_t end = part_start(part + 1);
+            for (std::size_t i = part_start(part); i < end; ++i) {
+                ++counts[records[i] >> shift];
+            }
+        });
+
+        std::size_t offset = 0;
+        for (std::size_t bucket = 0; bucket < bucket_count; ++bucket) {
+            bucket_starts[bucket] = offset;
+            for (auto& part_offsets : offsets) {
+                offset += std::exchange(part_offsets[bucket], offset);
+            }
+        }
+        bucket_starts[bucket_count] = n;
+
+        parallel_for(parts, parts, [&](std::size_t part) {
+            std::size_t* next = offsets[part].data();
+            const std::uint64_t* from = records.data();
+            std::uint64_t* to = buffer.data();
+            const std::size_t end = part_start(part + 1);
+            for (std::size_t i = part_start(part); i < end; ++i) {
+                to[next[from[i] >> shift]++] = from[i];
+            }
+        });
+        std::swap(split, spare);
+    } else {
+        bucket_starts[1] = n;
+    }
+
+    const int high_bit = 64 - split_bits;
+    parallel_for(bucket_count, thread_count, [&](std::size_t bucket) {
+        const std::size_t first = bucket_starts[bucket];
+        const std::size_t size = bucket_starts[bucket + 1] - first;
+        std::span<std::uint64_t> source = split.subspan(first, size);
+        std::span<std::uint64_t> target = spare.subspan(first, size);
+        std::vector<std::size_t> offsets;
+        for (int bit = low_bit; bit < high_bit; bit += 8) {
+            const std::uint64_t mask = (std::uint64_t{1} << std::min(8, high_bit - bit)) - 1;
+            radix_sort_detail::counting_pass(source, target, bit, mask, offsets);
+            std::swap(source, target);
+        }
+        finish(source, bucket, first);
+    });
+}
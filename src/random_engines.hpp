@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+
+// Small, fast UniformRandomBitGenerator engines. Every shuffle takes its
+// engine as a template parameter, so any of these (or a standard engine such
+// as std::mt19937) is called directly with no virtual dispatch.
+
+template <typename URBG>
+concept random_engine = std::uniform_random_bit_generator<std::remove_cvref_t<URBG>>;
+
+// SplitMix64 (Steele, Lea and Flood). One 64-bit add per output; mostly used
+// to expand a single seed into the state of the larger engines below.
+class splitmix64 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit splitmix64(std::uint64_t seed = 0) : state_(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() {
+        std::uint64_t z = (state_ += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+// xoshiro256** (Blackman and Vigna). 32 bytes of state, period 2^256 - 1.
+class xoshiro256ss {
+public:
+    using result_type = std::uint64_t;
+
+    explicit xoshiro256ss(std::uint64_t seed = 0) {
+        splitmix64 seeder(seed);
+        for (auto& word : state_) {
+            word = seeder();
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() {
+        const std::uint64_t result = std::rotl(state_[1] * 5, 7) * 9;
+        const std::uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = std::rotl(state_[3], 45);
+        return result;
+    }
+
+    // Advances the state by 2^128 outputs.
+    void jump() {
+        advance({0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c});
+    }
+
+    // Advances the state by 2^192 outputs.
+    void long_jump() {
+        advance({0x76e15d3efefdcbbf, 0xc5004e441c522fb3, 0x77710069854ee241, 0x39109bb02acbe635});
+    }
+
+    // The four state words, for code that runs several engines side by side.
+    const std::array<std::uint64_t, 4>& state() const { return state_; }
+
+    friend bool operator==(const xoshiro256ss&, const xoshiro256ss&) = default;
+
+private:
+    void advance(const std::array<std::uint64_t, 4>& polynomial) {
+        std::array<std::uint64_t, 4> jumped = {};
+        for (std::uint64_t word : polynomial) {
+            for (int bit = 0; bit < 64; ++bit) {
+                if (word & (std::uint64_t{1} << bit)) {
+                    for (size_t i = 0; i < jumped.size(); ++i) {
+                        jumped[i] ^= state_[i];
+                    }
+                }
+                (*this)();
+            }
+        }
+        state_ = jumped;
+    }
+
+    std::array<std::uint64_t, 4> state_;
+};
+
+// PCG64 (O'Neill): 128-bit LCG with the XSL-RR output function, as in
+// pcg64 from pcg-cpp and numpy. Odd increments select independent streams.
+class pcg64 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit pcg64(std::uint64_t seed = 0, std::uint64_t stream = 0)
+        : increment_((static_cast<unsigned __int128>(stream) << 1) | 1) {
+        step();
+        state_ += seed;
+        step();
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() {
+        step();
+        const std::uint64_t folded = static_cast<std::uint64_t>(state_ >> 64) ^ static_cast<std::uint64_t>(state_);
+        return std::rotr(folded, static_cast<int>(state_ >> 122));
+    }
+
+private:
+    static constexpr unsigned __int128 multiplier =
+        (static_cast<unsigned __int128>(0x2360ed051fc65da4) << 64) | 0x4385df649fccf645;
+
+    void step() { state_ = state_ * multiplier + increment_; }
+
+    unsigned __int128 state_ = 0;
+    unsigned __int128 increment_;
+};
+
+// wyrand (Wang Yi). One add and one 64x64->128 multiply per output.
+class wyrand {
+public:
+    using result_type = std::uint64_t;
+
+    explicit wyrand(std::uint64_t seed = 0) : state_(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() {
+        state_ += 0xa0761d6478bd642f;
+        const unsigned __int128 product = static_cast<unsigned __int128>(state_) * (state_ ^ 0xe7037ed1a0b428db);
+        return static_cast<std::uint64_t>(product >> 64) ^ static_cast<std::uint64_t>(product);
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+// Philox4x32-10 (Salmon et al., Random123). A keyed bijection of a 128-bit
+// counter; each counter value yields 128 bits, handed out as two 64-bit words.
+// The high half of the counter selects a stream and the low half counts
+// blocks within it, so every (seed, stream) pair is an independent sequence
+// of 2^65 words that can be started or skipped into in O(1).
+class philox4x32 {
+public:
+    using result_type = std::uint64_t;
+    using counter_type = std::array<std::uint32_t, 4>;
+    using key_type = std::array<std::uint32_t, 2>;
+
+    explicit philox4x32(std::uint64_t seed = 0, std::uint64_t stream = 0)
+        : key_{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)},
+          counter_{0, 0, static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)} {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() {
+        if (buffered_ == 0) {
+            block_ = generate(counter_, key_);
+            increment_counter();
+            buffered_ = 2;
+        }
+        const size_t word = 2 * (2 - buffered_--);
+        return (static_cast<std::uint64_t>(block_[word + 1]) << 32) | block_[word];
+    }
+
+    // The raw ten-round Philox function.
+    static counter_type generate(counter_type counter, key_type key) {
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                key[0] += 0x9e3779b9;
+                key[1] += 0xbb67ae85;
+            }
+            const std::uint64_t product0 = std::uint64_t{0xd2511f53} * counter[0];
+            const std::uint64_t product1 = std::uint64_t{0xcd9e8d57} * counter[2];
+            counter = {
+                static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                static_cast<std::uint32_t>(product1),
+                static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                static_cast<std::uint32_t>(product0),
+            };
+        }
+        return counter;
+    }
+
+    // Skips count outputs without generating them.
+    void discard(unsigned long long count) {
+        const unsigned long long buffered = std::min<unsigned long long>(count, buffered_);
+        buffered_ -= buffered;
+        count -= buffered;
+        if (count == 0) return;
+
+        const std::uint64_t block = (static_cast<std::uint64_t>(counter_[1]) << 32 | counter_[0]) + count / 2;
+        counter_[0] = static_cast<std::uint32_t>(block);
+        counter_[1] = static_cast<std::uint32_t>(block >> 32);
+        if (count % 2 == 1) {
+            (*this)();
+        }
+    }
+
+private:
+    // Only the block half of the counter advances; it wraps within the stream.
+    void increment_counter() {
+        if (++counter_[0] == 0) {
+            ++counter_[1];
+        }
+    }
+
+    key_type key_;
+    counter_type counter_;
+    counter_type block_ = {};
+    size_t buffered_ = 0;
+};
+
+// Engine behind the shuffles that are not handed one explicitly.
+using default_engine = xoshiro256ss;
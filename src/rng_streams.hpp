@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "random_engines.hpp"
+
+// Hands out independent default_engine streams derived from one master seed.
+// Stream k is the master engine advanced by k jumps of 2^128 outputs, so
+// streams never overlap and depend only on (master_seed, k), not on which
+// thread asks first or when. Building stream k costs k jumps (256 engine
+// steps each); use streams() when a whole pool needs engines.
+class rng_stream_manager {
+public:
+    explicit rng_stream_manager(std::uint64_t master_seed) : master_seed_(master_seed) {}
+
+    std::uint64_t master_seed() const { return master_seed_; }
+
+    default_engine stream(std::size_t stream_id) const {
+        default_engine engine(master_seed_);
+        for (std::size_t i = 0; i < stream_id; ++i) {
+            engine.jump();
+        }
+        return engine;
+    }
+
+    // Streams 0 .. count - 1, built with count - 1 jumps in total.
+    std::vector<default_engine> streams(std::size_t count) const {
+        std::vector<default_engine> engines;
+        engines.reserve(count);
+        default_engine engine(master_seed_);
+        for (std::size_t i = 0; i < count; ++i) {
+            engines.push_back(engine);
+            engine.jump();
+        }
+        return engines;
+    }
+
+private:
+    std::uint64_t master_seed_;
+};
+
+// Counter-based engine for deck `deck` of shoe `shoe` under master_seed. The
+// sequence depends only on those three values, never on what was drawn
+// before, so any deck of a run can be regenerated on any thread at the cost
+// of shuffling it once.
+inline philox4x32 deck_engine(std::uint64_t master_seed, std::uint32_t shoe, std::uint32_t deck) {
+    return philox4x32(master_seed, (static_cast<std::uint64_t>(shoe) << 32) | deck);
+}
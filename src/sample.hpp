@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include "bounded_random.hpp"
+#include "random_engines.hpp"
+#include "shuffle.hpp"
+
+// Choosing k distinct indices from [0, n). Every algorithm below picks each
+// k-subset with equal probability; unsorted output is also in uniformly
+// random order, sorted output is ascending. sample_k picks the algorithm
+// from k / n and the order wanted:
+//
+//  - Floyd's algorithm, for k up to n / 8 (n / 6 unsorted): k draws, with
+//    membership kept in a flat open-addressing table of 2-4k words, then a
+//    shuffle or an expected-linear bucket sort of the result. Memory and
+//    time depend on k only, so n can be 10^9 or 2^64 - 1.
+//  - Selection sampling (Knuth's Algorithm S), when k is a sizeable
+//    fraction of n: one pass over [0, n) that keeps each index with the
+//    exact conditional probability, emitting them in order straight into
+//    the output, which is Fisher-Yates shuffled when unsorted output is
+//    asked for. Time is O(n), which is O(k) here, and no memory is needed
+//    beyond the output.
+//
+// No path allocates more than O(k).
+
+enum class sample_order { unsorted, sorted };
+
+namespace sample_detail {
+    // Up to k = n / 8 Floyd's algorithm beats selection sampling for sorted
+    // output, and up to about n / 6 for unsorted output, which pays for a
+    // shuffle either way; past that the linear pass's cheaper steps win.
+    inline constexpr std::uint64_t floyd_min_ratio = 8;
+    inline constexpr std::uint64_t floyd_min_ratio_unsorted = 6;
+
+    // Open-addressing set of values below UINT64_MAX with linear probing
+    // and Fibonacci hashing; UINT64_MAX marks an empty slot.
+    class flat_index_set {
+    public:
+        explicit flat_index_set(std::size_t max_size)
+            : shift_(64 - std::max(1, static_cast<int>(std::bit_width(2 * std::max<std::size_t>(max_size, 1) - 1)))),
+              slots_(std::size_t{1} << (64 - shift_), empty) {}
+
+        // Inserts value; returns false if it was already present.
+        bool insert(std::uint64_t value) {
+            const std::size_t mask = slots_.size() - 1;
+            for (std::size_t slot = (value * 0x9e3779b97f4a7c15) >> shift_; ; slot = (slot + 1) & mask) {
+                if (slots_[slot] == value) return false;
+                if (slots_[slot] == empty) {
+                    slots_[slot] = value;
+                    return true;
+                }
+            }
+        }
+
+    private:
+        static constexpr std::uint64_t empty = UINT64_MAX;
+        int shift_;
+        std::vector<std::uint64_t> slots_;
+    };
+
+    // Sorts values that are spread uniformly over [0, n) in expected O(k):
+    // a counting sort into k buckets by value * k / n, then insertion sort
+    // within the buckets, which hold one value on average.
+    inline void sort_uniform(std::span<std::uint64_t> values, std::uint64_t n) {
+        const std::size_t k = values.size();
+        auto bucket_of = [&](std::uint64_t value) {
+            return static_cast<std::size_t>((static_cast<unsigned __int128>(value) * k) / n);
+        };
+        std::vector<std::size_t> starts(k + 1, 0);
+        for (std::uint64_t value : values) {
+            ++starts[bucket_of(value) + 1];
+        }
+        std::partial_sum(starts.begin(), starts.end(), starts.begin());
+        std::vector<std::uint64_t> sorted(k);
+        for (std::uint64_t value : values) {
+            sorted[starts[bucket_of(value)]++] = value;
+        }
+        for (std::size_t i = 1; i < k; ++i) {
+            const std::uint64_t value = sorted[i];
+            std::size_t j = i;
+            for (; j > 0 && sorted[j - 1] > value; --j) {
+                sorted[j] = sorted[j - 1];
+            }
+            sorted[j] = value;
+        }
+        std::copy(sorted.begin(), sorted.end(), values.begin());
+    }
+
+    // Floyd: for j = n - k .. n - 1 take a uniform t in [0, j], or j itself
+    // if t was taken already. The set is uniform; its order is not, so
+    // unsorted output is shuffled afterwards.
+    template <typename URBG>
+    void floyd(std::uint64_t n, std::span<std::uint64_t> out, URBG& rng, sample_order order) {
+        const std::size_t k = out.size();
+        flat_index_set taken(k);
+        std::size_t filled = 0;
+        for (std::uint64_t j = n - k; j < n; ++j) {
+            const std::uint64_t t = bounded_random(rng, j + 1);
+            out[filled++] = taken.insert(t) ? t : (taken.insert(j), j);
+        }
+        if (order == sample_order::sorted) {
+            sort_uniform(out, n);
+        } else {
+            shuffle_fisher_yates(out, rng);
+        }
+    }
+
+    // Knuth's Algorithm S: index i is kept with probability
+    // (k - kept) / (n - i). Always ascending.
+    template <typename URBG>
+    void selection(std::uint64_t n, std::span<std::uint64_t> out, URBG& rng) {
+        const std::size_t k = out.size();
+        std::size_t kept = 0;
+        for (std::uint64_t i = 0; kept < k; ++i) {
+            if (bounded_random(rng, n - i) < k - kept) {
+                out[kept++] = i;
+            }
+        }
+    }
+
+    // Algorithm S, then a shuffle of the output into uniform order.
+    template <typename URBG>
+    void shuffled_selection(std::uint64_t n, std::span<std::uint64_t> out, URBG& rng) {
+        selection(n, out, rng);
+        shuffle_fisher_yates(out, rng);
+    }
+}
+
+// Fills out with out.size() distinct indices from [0, n); out.size() must
+// not exceed n.
+template <random_engine URBG>
+void sample_k(std::uint64_t n, std::span<std::uint64_t> out, URBG&& rng, sample_order order = sample_order::unsorted) {
+    const std::uint64_t k = out.size();
+    if (k == 0) return;
+    if (order == sample_order::unsorted) {
+        if (k <= n / sample_detail::floyd_min_ratio_unsorted) {
+            sample_detail::floyd(n, out, rng, order);
+        } else {
+            sample_detail::shuffled_selection(n, out, rng);
+        }
+    } else if (k <= n / sample_detail::floyd_min_ratio) {
+        sample_detail::floyd(n, out, rng, order);
+    } else {
+        sample_detail::selection(n, out, rng);
+    }
+}
+
+template <random_engine URBG>
+std::vector<std::uint64_t> sample_k(std::uint64_t n, std::uint64_t k, URBG&& rng, sample_order order = sample_order::unsorted) {
+    std::vector<std::uint64_t> sample(k);
+    sample_k(n, std::span(sample), rng, order);
+    return sample;
+}
+
+inline std::vector<std::uint64_t> sample_k(std::uint64_t n, std::uint64_t k, sample_order order = sample_order::unsorted) {
+    return sample_k(n, k, get_rng(), order);
+}
@@ -2,39 +2,34 @@
 #include <vector>
 #include <random>
 #include <algorithm>
-#include <unordered_set>
-#include <chrono>
+#include <mutex>
 
 namespace {
-    std::mt19937 rng;
-    bool rng_initialized = false;
-}
+    // Source of the per-thread engines of threads that never call
+    // seed_thread_rng. The lock is only taken once per thread.
+    std::mutex unseeded_streams_mutex;
+    default_engine unseeded_streams(std::random_device{}() | (std::uint64_t{std::random_device{}()} << 32));
 
-std::mt19937& get_rng() {
-    if (!rng_initialized) {
-        auto seed = std::chrono::steady_clock::now().time_since_epoch().count();
-        rng.seed(seed);
-        rng_initialized = true;
+    default_engine next_unseeded_stream() {
+        std::lock_guard<std::mutex> lock(unseeded_streams_mutex);
+        default_engine engine = unseeded_streams;
+        unseeded_streams.jump();
+        return engine;
     }
+
+    thread_local default_engine rng = next_unseeded_stream();
+}
+
+default_engine& get_rng() {
     return rng;
 }
 
+void seed_thread_rng(std::uint64_t master_seed, std::size_t stream_id) {
+    rng = rng_stream_manager(master_seed).stream(stream_id);
+}
+
 void shuffle_random_sort(std::vector<int>& array) {
-    if (array.empty()) return;
-    
-    std::vector<int> result;
-    std::unordered_set<int> used_indices;
-    auto& rng = get_rng();
-    std::uniform_int_distribution<size_t> dist(0, array.size() - 1);
-    
-    while (result.size() < array.size()) {
-        size_t random_index = dist(rng);
-        if (used_indices.insert(random_index).second) {
-            result.push_back(array[random_index]);
-        }
-    }
-    
-    array = result;
+    shuffle_random_sort(std::span<int>(array));
 }
 
 void shuffle_naive_swap(std::vector<int>& array) {
@@ -50,12 +45,5 @@ void shuffle_naive_swap(std::vector<int>& array) {
 }
 
 void shuffle_fisher_yates(std::vector<int>& array) {
-    if (array.empty()) return;
-    
-    auto& rng = get_rng();
-    
-    for (size_t i = array.size() - 1; i > 0; --i) {
-        size_t random_index = rng() % (i + 1);
-        std::swap(array[i], array[random_index]);
-    }
+    shuffle_fisher_yates(std::span<int>(array));
 }
@@ -3,6 +3,31 @@
 #include <vector>
 #include <random>
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+#include "bounded_random.hpp"
+#include "parallel_for.hpp"
+#include "radix_sort.hpp"
+#include "random_engines.hpp"
+#include "rng_streams.hpp"
+
+// The calling thread's engine. Each thread gets its own; until
+// seed_thread_rng is called it is a fresh non-overlapping stream of a
+// process-wide random seed.
+default_engine& get_rng();
+
+// Makes the calling thread's get_rng() engine stream stream_id of
+// master_seed. Giving every worker thread its own stream id makes a
+// multi-threaded run reproducible.
+void seed_thread_rng(std::uint64_t master_seed, std::size_t stream_id = 0);
 
 void shuffle_random_sort(std::vector<int>& array);
 
@@ -10,3 +35,321 @@ void shuffle_naive_swap(std::vector<int>& array);
 
 void shuffle_fisher_yates(std::vector<int>& array);
 
+// Generic in-place overloads. They work on any element type through a
+// std::span and, apart from shuffle_random_sort's sort buffers, never
+// allocate; contiguous ranges (std::vector<std::uint8_t>, std::array, C
+// arrays, ...) are forwarded to the span versions. Each one takes an
+// optional engine and falls back to get_rng().
+
+template <typename Range>
+concept shuffleable_range = std::ranges::contiguous_range<Range>
+    && std::ranges::sized_range<Range>
+    && std::permutable<std::ranges::iterator_t<Range>>;
+
+template <typename Range>
+auto as_shuffle_span(Range&& range) {
+    return std::span<std::remove_reference_t<std::ranges::range_reference_t<Range>>>(
+        std::ranges::data(range), std::ranges::size(range));
+}
+
+template <typename T, random_engine URBG>
+void shuffle_naive_swap(std::span<T> array, URBG&& rng) {
+    if (array.empty()) return;
+
+    std::uniform_int_distribution<size_t> dist(0, array.size() - 1);
+
+    for (size_t i = 0; i < array.size(); ++i) {
+        size_t random_index = dist(rng);
+        std::swap(array[i], array[random_index]);
+    }
+}
+
+namespace shuffle_detail {
+    // K Fisher-Yates steps for the ranges n, n - 1, ..., n - K + 1, drawn
+    // from one random word.
+    template <std::size_t K, typename T, typename URBG>
+    void fisher_yates_batch(std::span<T> array, size_t n, URBG& rng) {
+        auto random_indices = bounded_random_descending<K>(rng, n);
+        for (size_t k = 0; k < K; ++k) {
+            std::swap(array[n - 1 - k], array[random_indices[k]]);
+        }
+    }
+
+    // Full Fisher-Yates pass. Large ranges get one word each; as the range
+    // shrinks more indices share a word, and the last few steps are drawn
+    // together. Batches stop at four: longer multiply chains cost more
+    // latency than a fast engine saves.
+    template <typename T, typename URBG>
+    void fisher_yates(std::span<T> array, URBG& rng) {
+        size_t n = array.size();
+        while (n > 4) {
+            if (n > max_batched_range<2>) {
+                fisher_yates_batch<1>(array, n, rng);
+                n -= 1;
+            } else if (n > max_batched_range<3>) {
+                fisher_yates_batch<2>(array, n, rng);
+                n -= 2;
+            } else if (n > max_batched_range<4>) {
+                fisher_yates_batch<3>(array, n, rng);
+                n -= 3;
+            } else {
+                fisher_yates_batch<4>(array, n, rng);
+                n -= 4;
+            }
+        }
+        switch (n) {
+            case 4: fisher_yates_batch<3>(array, n, rng); break;
+            case 3: fisher_yates_batch<2>(array, n, rng); break;
+            case 2: fisher_yates_batch<1>(array, n, rng); break;
+        }
+    }
+
+    // Steps the prefetching pass draws its index ahead of the swap. Enough
+    // to cover a DRAM miss at a few nanoseconds per step, small enough that
+    // the prefetched lines are still in L1 when the swap arrives.
+    inline constexpr size_t fisher_yates_prefetch_distance = 16;
+
+    // Same draws and swaps as fisher_yates(), but the random indices are
+    // drawn fisher_yates_prefetch_distance steps early and their cache lines
+    // prefetched, so the swap no longer waits for a miss. The indices depend
+    // only on the engine, not on the array, so the output is identical.
+    template <typename T, typename URBG>
+    void fisher_yates_prefetched(std::span<T> array, URBG& rng) {
+        constexpr size_t ring_size = 32;
+        static_assert(fisher_yates_prefetch_distance + 4 <= ring_size);
+
+        const size_t size = array.size();
+        const size_t steps = size - 1;
+        std::array<size_t, ring_size> ring;
+        size_t drawn = 0;
+
+        auto queue = [&]<size_t K>(const std::array<std::uint64_t, K>& random_indices) {
+            for (size_t k = 0; k < K; ++k) {
+                __builtin_prefetch(&array[random_indices[k]], 1);
+                ring[(drawn + k) % ring_size] = random_indices[k];
+            }
+            drawn += K;
+        };
+        // Mirrors the batch schedule of fisher_yates() step for step.
+        auto draw_next_batch = [&] {
+            const size_t n = size - drawn;
+            if (n > max_batched_range<2>) {
+                queue(bounded_random_descending<1>(rng, n));
+            } else if (n > max_batched_range<3>) {
+                queue(bounded_random_descending<2>(rng, n));
+            } else if (n > max_batched_range<4>) {
+                queue(bounded_random_descending<3>(rng, n));
+            } else if (n > 4) {
+                queue(bounded_random_descending<4>(rng, n));
+            } else if (n == 4) {
+                queue(bounded_random_descending<3>(rng, n));
+            } else if (n == 3) {
+                queue(bounded_random_descending<2>(rng, n));
+            } else {
+                queue(bounded_random_descending<1>(rng, n));
+            }
+        };
+
+        for (size_t step = 0; step < steps; ++step) {
+            while (drawn < steps && drawn < step + fisher_yates_prefetch_distance) {
+                draw_next_batch();
+            }
+            std::swap(array[size - 1 - step], array[ring[step % ring_size]]);
+        }
+    }
+}
+
+template <typename T, random_engine URBG>
+void shuffle_fisher_yates(std::span<T> array, URBG&& rng) {
+    if (array.empty()) return;
+
+    shuffle_detail::fisher_yates(array, rng);
+}
+
+// Same output as shuffle_fisher_yates for the same engine state, with the
+// random swap targets prefetched ahead; pays off once the array spills out
+// of the private caches.
+template <typename T, random_engine URBG>
+void shuffle_fisher_yates_prefetched(std::span<T> array, URBG&& rng) {
+    if (array.empty()) return;
+
+    shuffle_detail::fisher_yates_prefetched(array, rng);
+}
+
+namespace shuffle_detail {
+    // Keys are drawn in fixed blocks and ties are broken per sort bucket,
+    // each with its own stream, so the result does not depend on the number
+    // of threads.
+    inline constexpr size_t random_sort_min_block = size_t{1} << 16;
+    inline constexpr size_t random_sort_max_blocks = 1024;
+
+    // Elements this small ride along in the sort records themselves;
+    // anything else is represented by its index and gathered afterwards.
+    template <typename T>
+    inline constexpr bool random_sort_packs_elements = std::is_trivially_copyable_v<T> && sizeof(T) <= 4;
+
+    // Key bytes sorted on: about 8 bits more than log2(size), so only a
+    // small fraction of the keys collide, and at most the 32 key bits.
+    inline int random_sort_key_bytes(size_t size) {
+        return std::min(4, (static_cast<int>(std::bit_width(size)) + 8 + 7) / 8);
+    }
+
+    // Each record holds a random key in its high 32 bits and the element
+    // (or its index) in the low 32. Sorting on the top key_bytes bytes
+    // orders the elements by independent uniform keys; runs of equal keys
+    // are then Fisher-Yates shuffled, so ties cannot favour the input order
+    // and the result is a uniform permutation for any key width.
+    template <typename T>
+    void random_sort(std::span<T> array, const rng_stream_manager& streams, size_t thread_count,
+                     int key_bytes) {
+        const size_t n = array.size();
+        const size_t blocks = std::min(std::bit_floor(std::max<size_t>(1, n / random_sort_min_block)),
+                                       random_sort_max_blocks);
+        const int low_bit = 64 - 8 * key_bytes;
+        // Streams 0 .. blocks - 1 draw the keys, the rest break the ties.
+        std::vector<default_engine> engines = streams.streams(blocks + radix_sort_bucket_count(n, low_bit));
+        auto block_start = [&](size_t block) { return block * n / blocks; };
+
+        auto records = std::make_unique_for_overwrite<std::uint64_t[]>(n);
+        auto buffer = std::make_unique_for_overwrite<std::uint64_t[]>(n);
+        parallel_for(blocks, thread_count, [&](size_t block) {
+            // A local engine and bounds: the record stores could alias them.
+            default_engine rng = engines[block];
+            const size_t first = block_start(block);
+            const size_t end = block_start(block + 1);
+            std::uint64_t* block_records = records.get();
+            std::uint64_t keys = 0;
+            for (size_t i = first; i < end; ++i) {
+                std::uint32_t payload = static_cast<std::uint32_t>(i);
+                if constexpr (random_sort_packs_elements<T>) {
+                    payload = 0;
+                    std::memcpy(&payload, &array[i], sizeof(T));
+                }
+                // Two keys per random word.
+                const bool fresh = (i - first) % 2 == 0;
+                if (fresh) keys = rng();
+                block_records[i] = (fresh ? keys & 0xffffffff00000000 : keys << 32) | payload;
+            }
+            engines[block] = rng;
+        });
+
+        // Runs of equal keys never cross buckets, so each bucket breaks its
+        // own ties and writes its elements out while it is in cache.
+        std::unique_ptr<T[]> shuffled;
+        if constexpr (!random_sort_packs_elements<T>) {
+            shuffled = std::make_unique_for_overwrite<T[]>(n);
+        }
+        auto finish = [&](std::span<std::uint64_t> sorted, size_t bucket, size_t first) {
+            for (size_t i = 0; i < sorted.size(); ) {
+                size_t run_end = i + 1;
+                while (run_end < sorted.size() && (sorted[run_end] >> low_bit) == (sorted[i] >> low_bit)) {
+                    ++run_end;
+                }
+                if (run_end - i > 1) {
+                    shuffle_fisher_yates(sorted.subspan(i, run_end - i), engines[blocks + bucket]);
+                }
+                i = run_end;
+            }
+            for (size_t i = 0; i < sorted.size(); ++i) {
+                const auto payload = static_cast<std::uint32_t>(sorted[i]);
+                if constexpr (random_sort_packs_elements<T>) {
+                    std::memcpy(&array[first + i], &payload, sizeof(T));
+                } else {
+                    shuffled[first + i] = std::move(array[payload]);
+                }
+            }
+        };
+        radix_sort_by_high_bits(std::span<std::uint64_t>(records.get(), n), std::span<std::uint64_t>(buffer.get(), n),
+                                low_bit, thread_count, finish);
+
+        if constexpr (!random_sort_packs_elements<T>) {
+            std::move(shuffled.get(), shuffled.get() + n, array.begin());
+        }
+    }
+}
+
+// Random-key sort shuffle: every element gets a random key and the keys are
+// radix sorted in parallel (see shuffle_detail::random_sort). Uniform, and
+// the result depends only on the streams and the array size, not on
+// thread_count (0 means default_thread_count()). Arrays of 2^32 or more
+// elements are Fisher-Yates shuffled with stream 0 instead.
+template <typename T>
+void shuffle_random_sort(std::span<T> array, const rng_stream_manager& streams, size_t thread_count = 0) {
+    if (array.size() <= 1) return;
+    if (array.size() > UINT32_MAX) {
+        shuffle_fisher_yates(array, streams.stream(0));
+        return;
+    }
+    shuffle_detail::random_sort(array, streams, thread_count, shuffle_detail::random_sort_key_bytes(array.size()));
+}
+
+// Seeds the streams from rng.
+template <typename T, random_engine URBG>
+void shuffle_random_sort(std::span<T> array, URBG&& rng) {
+    shuffle_random_sort(array, rng_stream_manager(random_bits64(rng)));
+}
+
+template <typename T>
+void shuffle_random_sort(std::span<T> array) {
+    shuffle_random_sort(array, get_rng());
+}
+
+template <typename T>
+void shuffle_naive_swap(std::span<T> array) {
+    shuffle_naive_swap(array, get_rng());
+}
+
+template <typename T>
+void shuffle_fisher_yates(std::span<T> array) {
+    shuffle_fisher_yates(array, get_rng());
+}
+
+template <typename T>
+void shuffle_fisher_yates_prefetched(std::span<T> array) {
+    shuffle_fisher_yates_prefetched(array, get_rng());
+}
+
+template <shuffleable_range Range, random_engine URBG>
+void shuffle_random_sort(Range&& array, URBG&& rng) {
+    shuffle_random_sort(as_shuffle_span(array), rng);
+}
+
+template <shuffleable_range Range, random_engine URBG>
+void shuffle_naive_swap(Range&& array, URBG&& rng) {
+    shuffle_naive_swap(as_shuffle_span(array), rng);
+}
+
+template <shuffleable_range Range, random_engine URBG>
+void shuffle_fisher_yates(Range&& array, URBG&& rng) {
+    shuffle_fisher_yates(as_shuffle_span(array), rng);
+}
+
+template <shuffleable_range Range, random_engine URBG>
+void shuffle_fisher_yates_prefetched(Range&& array, URBG&& rng) {
+    shuffle_fisher_yates_prefetched(as_shuffle_span(array), rng);
+}
+
+template <shuffleable_range Range>
+void shuffle_random_sort(Range&& array, const rng_stream_manager& streams, size_t thread_count = 0) {
+    shuffle_random_sort(as_shuffle_span(array), streams, thread_count);
+}
+
+template <shuffleable_range Range>
+void shuffle_random_sort(Range&& array) {
+    shuffle_random_sort(as_shuffle_span(array));
+}
+
+template <shuffleable_range Range>
+void shuffle_naive_swap(Range&& array) {
+    shuffle_naive_swap(as_shuffle_span(array));
+}
+
+template <shuffleable_range Range>
+void shuffle_fisher_yates(Range&& array) {
+    shuffle_fisher_yates(as_shuffle_span(array));
+}
+
+template <shuffleable_range Range>
+void shuffle_fisher_yates_prefetched(Range&& array) {
+    shuffle_fisher_yates_prefetched(as_shuffle_span(array));
+}
@@ -0,0 +1,140 @@
+#include "simd_random.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_RANDOM_X86 1
+#endif
+
+namespace {
+    using lane_state = std::array<std::array<std::uint64_t, xoshiro256ss_x8::lanes>, 4>;
+    constexpr std::size_t lanes = xoshiro256ss_x8::lanes;
+
+    void generate_scalar(lane_state& state, std::uint64_t* out, std::size_t steps) {
+        // A local copy, so stores to out cannot alias the state.
+        lane_state s = state;
+        for (std::size_t step = 0; step < steps; ++step, out += lanes) {
+            for (std::size_t lane = 0; lane < lanes; ++lane) {
+                out[lane] = std::rotl(s[1][lane] * 5, 7) * 9;
+                const std::uint64_t t = s[1][lane] << 17;
+                s[2][lane] ^= s[0][lane];
+                s[3][lane] ^= s[1][lane];
+                s[1][lane] ^= s[2][lane];
+                s[0][lane] ^= s[3][lane];
+                s[2][lane] ^= t;
+                s[3][lane] = std::rotl(s[3][lane], 45);
+            }
+        }
+        state = s;
+    }
+
+#ifdef SIMD_RANDOM_X86
+    // AVX2 has no 64-bit rotate or multiply: x * 5 and x * 9 become shifts
+    // and adds, rotates become two shifts and an or.
+    __attribute__((target("avx2"))) inline __m256i rotl_avx2(__m256i x, int k) {
+        return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+    }
+
+    __attribute__((target("avx2"))) void generate_avx2(lane_state& s, std::uint64_t* out, std::size_t steps) {
+        // Lanes 0-3 and 4-7 are two independent dependency chains.
+        __m256i s0[2], s1[2], s2[2], s3[2];
+        for (int half = 0; half < 2; ++half) {
+            s0[half] = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[0].data() + 4 * half));
+            s1[half] = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[1].data() + 4 * half));
+            s2[half] = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[2].data() + 4 * half));
+            s3[half] = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[3].data() + 4 * half));
+        }
+        for (std::size_t step = 0; step < steps; ++step, out += lanes) {
+            for (int half = 0; half < 2; ++half) {
+                const __m256i times5 = _mm256_add_epi64(_mm256_slli_epi64(s1[half], 2), s1[half]);
+                const __m256i rotated = rotl_avx2(times5, 7);
+                const __m256i result = _mm256_add_epi64(_mm256_slli_epi64(rotated, 3), rotated);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4 * half), result);
+
+                const __m256i t = _mm256_slli_epi64(s1[half], 17);
+                s2[half] = _mm256_xor_si256(s2[half], s0[half]);
+                s3[half] = _mm256_xor_si256(s3[half], s1[half]);
+                s1[half] = _mm256_xor_si256(s1[half], s2[half]);
+                s0[half] = _mm256_xor_si256(s0[half], s3[half]);
+                s2[half] = _mm256_xor_si256(s2[half], t);
+                s3[half] = rotl_avx2(s3[half], 45);
+            }
+        }
+        for (int half = 0; half < 2; ++half) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(s[0].data() + 4 * half), s0[half]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(s[1].data() + 4 * half), s1[half]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(s[2].data() + 4 * half), s2[half]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(s[3].data() + 4 * half), s3[half]);
+        }
+    }
+
+    __attribute__((target("avx512f"))) void generate_avx512(lane_state& s, std::uint64_t* out, std::size_t steps) {
+        __m512i s0 = _mm512_load_si512(s[0].data());
+        __m512i s1 = _mm512_load_si512(s[1].data());
+        __m512i s2 = _mm512_load_si512(s[2].data());
+        __m512i s3 = _mm512_load_si512(s[3].data());
+        for (std::size_t step = 0; step < steps; ++step, out += lanes) {
+            const __m512i times5 = _mm512_add_epi64(_mm512_slli_epi64(s1, 2), s1);
+            const __m512i rotated = _mm512_rol_epi64(times5, 7);
+            _mm512_storeu_si512(out, _mm512_add_epi64(_mm512_slli_epi64(rotated, 3), rotated));
+
+            const __m512i t = _mm512_slli_epi64(s1, 17);
+            s2 = _mm512_xor_si512(s2, s0);
+            s3 = _mm512_xor_si512(s3, s1);
+            s1 = _mm512_xor_si512(s1, s2);
+            s0 = _mm512_xor_si512(s0, s3);
+            s2 = _mm512_xor_si512(s2, t);
+            s3 = _mm512_rol_epi64(s3, 45);
+        }
+        _mm512_store_si512(s[0].data(), s0);
+        _mm512_store_si512(s[1].data(), s1);
+        _mm512_store_si512(s[2].data(), s2);
+        _mm512_store_si512(s[3].data(), s3);
+    }
+#endif
+
+    // Writes steps * lanes words to out.
+    void generate(lane_state& s, std::uint64_t* out, std::size_t steps, simd_backend backend) {
+        switch (backend) {
+#ifdef SIMD_RANDOM_X86
+            case simd_backend::avx512: generate_avx512(s, out, steps); return;
+            case simd_backend::avx2: generate_avx2(s, out, steps); return;
+#endif
+            default: generate_scalar(s, out, steps); return;
+        }
+    }
+}
+
+xoshiro256ss_x8::xoshiro256ss_x8(std::uint64_t seed, simd_backend backend) : backend_(backend) {
+    xoshiro256ss lane_engine(seed);
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+        for (std::size_t word = 0; word < 4; ++word) {
+            state_[word][lane] = lane_engine.state()[word];
+        }
+        lane_engine.jump();
+    }
+}
+
+void xoshiro256ss_x8::refill() {
+    generate(state_, buffer_.data(), buffer_words / lanes, backend_);
+    next_ = 0;
+}
+
+void xoshiro256ss_x8::fill(std::uint64_t* out, std::size_t count) {
+    const std::size_t buffered = std::min(count, buffer_words - next_);
+    std::memcpy(out, buffer_.data() + next_, buffered * sizeof(std::uint64_t));
+    next_ += buffered;
+    out += buffered;
+    count -= buffered;
+
+    const std::size_t whole_steps = count / lanes;
+    generate(state_, out, whole_steps, backend_);
+    out += whole_steps * lanes;
+    count -= whole_steps * lanes;
+
+    for (; count > 0; --count) {
+        *out++ = (*this)();
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "cpu_features.hpp"
+#include "random_engines.hpp"
+
+// Eight xoshiro256** engines run in lockstep, one per SIMD lane, and a
+// buffer of their outputs is handed out one word at a time. Lane k starts as
+// stream k of rng_stream_manager(seed), so the lanes never overlap; the
+// buffer holds step 0 of lanes 0..7, then step 1 of lanes 0..7, and so on.
+//
+// The lanes are advanced with AVX-512 (one register per state word), AVX2
+// (two registers per state word) or plain scalar code. The backend is picked
+// at run time from what the CPU supports; every backend produces the same
+// words, so results do not depend on the machine.
+
+class xoshiro256ss_x8 {
+public:
+    using result_type = std::uint64_t;
+
+    static constexpr std::size_t lanes = 8;
+    static constexpr std::size_t buffer_words = 512;
+
+    // backend must be supported by the running CPU.
+    explicit xoshiro256ss_x8(std::uint64_t seed = 0, simd_backend backend = best_simd_backend());
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() {
+        if (next_ == buffer_words) {
+            refill();
+        }
+        return buffer_[next_++];
+    }
+
+    // Writes the next count words to out, the same words count calls to
+    // operator() would return. Whole steps of all lanes bypass the buffer.
+    void fill(std::uint64_t* out, std::size_t count);
+
+    simd_backend backend() const { return backend_; }
+
+private:
+    void refill();
+
+    // state_[word][lane]: word i of every lane is one vector.
+    alignas(64) std::array<std::array<std::uint64_t, lanes>, 4> state_;
+    alignas(64) std::array<std::uint64_t, buffer_words> buffer_;
+    std::size_t next_ = buffer_words;
+    simd_backend backend_;
+};
@@ -0,0 +1,80 @@
+#include "weighted_shuffle.hpp"
+#include <bit>
+
+namespace {
+    // Inlined into the target-specific wrappers below, where the compiler
+    // vectorizes it for the wider instruction set. Only integer operations,
+    // adds, multiplies and divides, so every backend rounds alike as long as
+    // nothing is contracted into FMAs.
+    [[gnu::always_inline]] inline void key_records(const double* weights, std::uint64_t* records,
+                                                   std::size_t count, std::uint32_t first) {
+        constexpr std::uint64_t one_bits = 0x3ff0000000000000;
+        constexpr double ln2 = 0.6931471805599453094;
+        for (std::size_t i = 0; i < count; ++i) {
+            // u in (0, 1] from 52 random bits.
+            const double u = 2.0 - std::bit_cast<double>((records[i] >> 12) | one_bits);
+
+            // u = 2^e * m with m in [sqrt(1/2), sqrt(2)).
+            const std::uint64_t bits = std::bit_cast<std::uint64_t>(u);
+            const std::uint64_t high_mantissa = (bits & 0x000fffffffffffff) > 0x6a09e667f3bcc ? 1 : 0;
+            const std::uint64_t exponent = (bits >> 52) + high_mantissa;
+            const double m = std::bit_cast<double>((bits & 0x000fffffffffffff) | (one_bits - (high_mantissa << 52)));
+            // exponent as a double without a 64-bit integer conversion.
+            const double e = std::bit_cast<double>(0x4330000000000000 | exponent) - 4503599627370496.0 - 1023.0;
+
+            // ln m = 2 atanh(s), s = (m - 1) / (m + 1), |s| < 0.1716; the
+            // series to s^13 is good to about 4e-13.
+            const double s = (m - 1.0) / (m + 1.0);
+            const double s2 = s * s;
+            double series = 1.0 / 13.0;
+            series = series * s2 + 1.0 / 11.0;
+            series = series * s2 + 1.0 / 9.0;
+            series = series * s2 + 1.0 / 7.0;
+            series = series * s2 + 1.0 / 5.0;
+            series = series * s2 + 1.0 / 3.0;
+            series = series * s2 + 1.0;
+            const double minus_ln_u = -(e * ln2 + 2.0 * s * series);
+
+            // Divides by 1 instead of 0 and blends in the infinite key with
+            // a mask: a branch here would keep the loop from vectorizing.
+            const double weight = weights[i];
+            const std::uint64_t positive = std::uint64_t{0} - static_cast<std::uint64_t>(weight > 0.0);
+            const double divisor = std::bit_cast<double>((std::bit_cast<std::uint64_t>(weight) & positive) |
+                                                         (one_bits & ~positive));
+            // -ln(1) can come out as -0.0; its sign bit would sort it last.
+            const std::uint32_t quotient_bits =
+                std::bit_cast<std::uint32_t>(static_cast<float>(minus_ln_u / divisor)) & 0x7fffffff;
+            const std::uint32_t key_bits = (quotient_bits & static_cast<std::uint32_t>(positive)) |
+                                           (0x7f800000 & ~static_cast<std::uint32_t>(positive));
+            records[i] = std::uint64_t{key_bits} << 32 | (first + static_cast<std::uint32_t>(i));
+        }
+    }
+
+    [[gnu::optimize("fp-contract=off")]] void key_records_scalar(
+            const double* weights, std::uint64_t* records, std::size_t count, std::uint32_t first) {
+        key_records(weights, records, count, first);
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    [[gnu::optimize("fp-contract=off")]] __attribute__((target("avx2"))) void key_records_avx2(
+            const double* weights, std::uint64_t* records, std::size_t count, std::uint32_t first) {
+        key_records(weights, records, count, first);
+    }
+
+    [[gnu::optimize("fp-contract=off")]] __attribute__((target("avx512f,avx512bw"))) void key_records_avx512(
+            const double* weights, std::uint64_t* records, std::size_t count, std::uint32_t first) {
+        key_records(weights, records, count, first);
+    }
+#define WEIGHTED_SHUFFLE_X86 1
+#endif
+}
+
+void weighted_shuffle_detail::exponential_key_records(const double* weights, std::uint64_t* records,
+                                                      std::size_t count, std::uint32_t first,
+                                                      simd_backend backend) {
+#ifdef WEIGHTED_SHUFFLE_X86
+    if (backend == simd_backend::avx512) return key_records_avx512(weights, records, count, first);
+    if (backend == simd_backend::avx2) return key_records_avx2(weights, records, count, first);
+#endif
+    key_records_scalar(weights, records, count, first);
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "bounded_random.hpp"
+#include "parallel_for.hpp"
+#include "radix_sort.hpp"
+#include "random_engines.hpp"
+#include "shuffle.hpp"
+#include "simd_random.hpp"
+
+// Weighted random order (Efraimidis and Spirakis): item i gets the key
+// E_i / w_i with E_i exponential, and the items sorted by ascending key are
+// in the order of repeatedly drawing a remaining item with probability
+// proportional to its weight. Items of weight 0 come last.
+//
+// The keys are computed across SIMD lanes with a polynomial logarithm
+// (relative error below 1e-12) from xoshiro256ss_x8 words seeded by the
+// caller's engine, and stored as a float in the high half of a 64-bit
+// record whose low half is the item index. A full order is one
+// radix_sort_by_high_bits of the records; the first k items of the order
+// come from a per-block partial selection, in parallel. Items whose float
+// keys are equal, which at 10^7 items happens to thousands of pairs, are
+// ordered by a seeded hash of their index, so ties fall in random order
+// rather than index order; two exact keys that close are about equally
+// likely to come in either order anyway. Results do not depend on the
+// thread count or the SIMD backend, and a top-k order is always the prefix
+// of the full order drawn with the same engine.
+
+namespace weighted_shuffle_detail {
+    // Key records are built in blocks of this many, and the top-k selection
+    // uses blocks at least this big.
+    inline constexpr std::size_t top_k_block = std::size_t{1} << 16;
+
+    // Up to n / 16, selecting the first k beats sorting everything.
+    inline constexpr std::size_t top_k_max_ratio = 16;
+
+    // Turns the random words in records[0, count) into key records for the
+    // items first .. first + count - 1.
+    void exponential_key_records(const double* weights, std::uint64_t* records, std::size_t count,
+                                 std::uint32_t first, simd_backend backend);
+
+    // Key records for every item, built in parallel blocks.
+    template <typename URBG>
+    std::vector<std::uint64_t> key_records(std::span<const double> weights, URBG& rng, std::size_t thread_count,
+                                           simd_backend backend) {
+        const std::size_t n = weights.size();
+        std::vector<std::uint64_t> records(n);
+        xoshiro256ss_x8 words(random_bits64(rng), backend);
+        words.fill(records.data(), n);
+        const std::size_t blocks = (n + top_k_block - 1) / top_k_block;
+        parallel_for(blocks, thread_count, [&](std::size_t block) {
+            const std::size_t first = block * top_k_block;
+            const std::size_t count = std::min(top_k_block, n - first);
+            exponential_key_records(weights.data() + first, records.data() + first, count,
+                                    static_cast<std::uint32_t>(first), backend);
+        });
+        return records;
+    }
+
+    // Position of a record among records with the same key: a bijective
+    // hash of its index, so no two records tie again.
+    inline std::uint64_t tie_rank(std::uint64_t record, std::uint64_t tie_seed) {
+        return splitmix64(tie_seed + static_cast<std::uint32_t>(record))();
+    }
+
+    // Reorders each run of equal keys in sorted records by tie_rank.
+    inline void order_key_ties(std::span<std::uint64_t> sorted, std::uint64_t tie_seed) {
+        auto by_tie_rank = [tie_seed](std::uint64_t a, std::uint64_t b) {
+            return tie_rank(a, tie_seed) < tie_rank(b, tie_seed);
+        };
+        for (std::size_t i = 0; i < sorted.size(); ) {
+            std::size_t run_end = i + 1;
+            while (run_end < sorted.size() && (sorted[run_end] >> 32) == (sorted[i] >> 32)) {
+                ++run_end;
+            }
+            if (run_end - i > 1) {
+                std::sort(sorted.begin() + i, sorted.begin() + run_end, by_tie_rank);
+            }
+            i = run_end;
+        }
+    }
+}
+
+// Writes the indices of the first order.size() items of a weighted random
+// order of weights. Weights must be finite and non-negative, and there may
+// be at most 2^32 of them.
+template <random_engine URBG>
+void weighted_order(std::span<const double> weights, std::span<std::uint32_t> order, URBG&& rng,
+                    std::size_t thread_count = 0, simd_backend backend = best_simd_backend()) {
+    using namespace weighted_shuffle_detail;
+    const std::size_t n = weights.size();
+    const std::size_t k = std::min(order.size(), n);
+    if (k == 0) return;
+    std::vector<std::uint64_t> records = key_records(weights, rng, thread_count, backend);
+    const std::uint64_t tie_seed = random_bits64(rng);
+
+    if (k > n / top_k_max_ratio) {
+        auto buffer = std::make_unique_for_overwrite<std::uint64_t[]>(n);
+        radix_sort_by_high_bits(records, std::span(buffer.get(), n), 32, thread_count,
+                                [&](std::span<std::uint64_t> sorted, std::size_t, std::size_t first) {
+            if (first >= k) return;
+            order_key_ties(sorted, tie_seed);
+            const std::size_t end = std::min(first + sorted.size(), k);
+            for (std::size_t i = first; i < end; ++i) {
+                order[i] = static_cast<std::uint32_t>(sorted[i - first]);
+            }
+        });
+        return;
+    }
+
+    // Every block keeps its k smallest records in front; the k smallest
+    // overall are among those. Blocks of at least 16k records cut the
+    // candidates to at most a sixteenth of the items.
+    const std::size_t block_size = std::max(top_k_block, k * top_k_max_ratio);
+    const std::size_t blocks = (n + block_size - 1) / block_size;
+    parallel_for(blocks, thread_count, [&](std::size_t block) {
+        auto first = records.begin() + block * block_size;
+        auto last = records.begin() + std::min(n, (block + 1) * block_size);
+        if (last - first > static_cast<std::ptrdiff_t>(k)) {
+            std::nth_element(first, first + k, last);
+        }
+    });
+    std::vector<std::uint64_t> candidates;
+    candidates.reserve(blocks * k);
+    for (std::size_t block = 0; block < blocks; ++block) {
+        auto first = records.begin() + block * block_size;
+        candidates.insert(candidates.end(), first, first + std::min(k, n - block * block_size));
+    }
+    std::nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end());
+    std::sort(candidates.begin(), candidates.begin() + k);
+
+    // Every record with a key below the k-th is a candidate, but records
+    // tied with it may have been left out anywhere. They are gathered from
+    // all blocks, and the last places go to those first by tie_rank.
+    const std::uint64_t boundary = candidates[k - 1] >> 32;
+    const std::size_t below = static_cast<std::size_t>(
+        std::lower_bound(candidates.begin(), candidates.begin() + k, boundary << 32) - candidates.begin());
+    std::vector<std::vector<std::uint64_t>> tied_by_block(blocks);
+    parallel_for(blocks, thread_count, [&](std::size_t block) {
+        const std::size_t end = std::min(n, (block + 1) * block_size);
+        for (std::size_t i = block * block_size; i < end; ++i) {
+            if ((records[i] >> 32) == boundary) tied_by_block[block].push_back(records[i]);
+        }
+    });
+    std::vector<std::uint64_t> tied;
+    for (const auto& block_tied : tied_by_block) {
+        tied.insert(tied.end(), block_tied.begin(), block_tied.end());
+    }
+    std::sort(tied.begin(), tied.end(), [tie_seed](std::uint64_t a, std::uint64_t b) {
+        return tie_rank(a, tie_seed) < tie_rank(b, tie_seed);
+    });
+    std::copy_n(tied.begin(), k - below, candidates.begin() + below);
+    order_key_ties(std::span(candidates.data(), below), tie_seed);
+    for (std::size_t i = 0; i < k; ++i) {
+        order[i] = static_cast<std::uint32_t>(candidates[i]);
+    }
+}
+
+template <random_engine URBG>
+std::vector<std::uint32_t> weighted_order(std::span<const double> weights, std::size_t k, URBG&& rng,
+                                          std::size_t thread_count = 0) {
+    std::vector<std::uint32_t> order(std::min(k, weights.size()));
+    weighted_order(weights, std::span(order), rng, thread_count);
+    return order;
+}
+
+// Reorders items into a weighted random order; weights[i] belongs to the
+// item at position i before the call.
+template <typename T, random_engine URBG>
+void weighted_shuffle(std::span<T> items, std::span<const double> weights, URBG&& rng, std::size_t thread_count = 0) {
+    std::vector<std::uint32_t> order = weighted_order(weights, items.size(), rng, thread_count);
+    std::vector<T> shuffled;
+    shuffled.reserve(items.size());
+    for (std::uint32_t index : order) {
+        shuffled.push_back(std::move(items[index]));
+    }
+    std::move(shuffled.begin(), shuffled.end(), items.begin());
+}
+
+template <typename T>
+void weighted_shuffle(std::span<T> items, std::span<const double> weights) {
+    weighted_shuffle(items, weights, get_rng());
+}
+
+template <shuffleable_range Range, random_engine URBG>
+void weighted_shuffle(Range&& items, std::span<const double> weights, URBG&& rng, std::size_t thread_count = 0) {
+    weighted_shuffle(as_shuffle_span(items), weights, rng, thread_count);
+}
+
+template <shuffleable_range Range>
+void weighted_shuffle(Range&& items, std::span<const double> weights) {
+    weighted_shuffle(as_shuffle_span(items), weights);
+}
@@ -0,0 +1,159 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <utility>
+#include "../src/binomial.hpp"
+
+namespace {
+    // Keeps arguments out of the optimizer's sight in the benchmarks.
+    std::uint64_t opaque(std::uint64_t value) {
+        volatile std::uint64_t copy = value;
+        return copy;
+    }
+
+    // Single-deck rank counts: nine ranks of four and sixteen ten-valued
+    // cards.
+    constexpr std::array<std::uint32_t, 10> single_deck = {4, 4, 4, 4, 4, 4, 4, 4, 4, 16};
+}
+
+TEST_CASE("Binomial - Correctness Tests", "[binomial]") {
+    SECTION("Pascal table") {
+        static_assert(*choose_u64(52, 5) == 2598960);
+        static_assert(*choose_u64(67, 33) == 14226520737620288370ULL);
+        for (std::uint64_t n = 0; n <= pascal_max_n; ++n) {
+            REQUIRE(*choose_u64(n, 0) == 1);
+            REQUIRE(*choose_u64(n, n) == 1);
+            REQUIRE(*choose_u64(n, n + 1) == 0);
+            for (std::uint64_t k = 1; k <= n; ++k) {
+                // C(n, k) k = C(n, k - 1) (n - k + 1), checked in 128 bits.
+                REQUIRE(static_cast<unsigned __int128>(*choose_u64(n, k)) * k
+                        == static_cast<unsigned __int128>(*choose_u64(n, k - 1)) * (n - k + 1));
+            }
+        }
+    }
+
+    SECTION("Beyond the table") {
+        REQUIRE(*choose_u64(100, 3) == 161700);
+        REQUIRE(*choose_u64(416, 5) == 416ULL * 415 * 414 * 413 * 412 / 120);
+        // C(68, 34) = C(67, 33) 68 / 34 no longer fits in 64 bits.
+        REQUIRE(*choose_u128(68, 34) == static_cast<unsigned __int128>(*choose_u64(67, 33)) * 2);
+        REQUIRE(choose_u64(68, 34).error() == factorial_error::overflow);
+        REQUIRE(choose_u128(416, 15).has_value());
+        REQUIRE(choose_u128(416, 208).error() == factorial_error::overflow);
+        for (std::uint64_t n = 68; n < 200; n += 7) {
+            for (std::uint64_t k = 0; k <= 12; ++k) {
+                REQUIRE(*choose_u128(n, k) == *choose_u128(n - 1, k) + (k > 0 ? *choose_u128(n - 1, k - 1) : 0));
+            }
+        }
+    }
+
+    SECTION("Multinomials") {
+        const std::array<std::uint32_t, 7> counts = {2, 2, 2, 2, 2, 2, 8};
+        REQUIRE(*multinomial(counts) == 942809868000ULL);
+        REQUIRE(*multinomial(std::array<std::uint32_t, 0>{}) == 1);
+        REQUIRE(multinomial(single_deck).error() == factorial_error::overflow);
+        REQUIRE(std::fabs(log_multinomial(counts) - std::log(942809868000.0)) < 1e-12);
+        // 52! / (4!^9 16!) = 1.4592430146087411e42.
+        REQUIRE(std::fabs(log_multinomial(single_deck) - std::log(1.4592430146087411e42)) < 1e-12);
+    }
+
+    SECTION("Composition probabilities") {
+        // Two aces from a fresh deck: C(4, 2) / C(52, 2).
+        std::array<std::uint32_t, 10> drawn = {2, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+        REQUIRE(std::fabs(composition_probability(single_deck, drawn) - 6.0 / 1326.0) < 1e-16);
+        drawn = {5, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+        REQUIRE(composition_probability(single_deck, drawn) == 0.0);
+        // A hand that does not list one count per rank is impossible, not
+        // read past its end.
+        const std::array<std::uint32_t, 3> short_hand = {1, 1, 0};
+        REQUIRE(composition_probability(single_deck, short_hand) == 0.0);
+        const std::array<std::uint32_t, 11> long_hand = {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+        REQUIRE(composition_probability(single_deck, long_hand) == 0.0);
+
+        // The probabilities of every two-card composition add up to one.
+        double total = 0.0;
+        for (std::size_t a = 0; a < 10; ++a) {
+            for (std::size_t b = a; b < 10; ++b) {
+                std::array<std::uint32_t, 10> hand = {};
+                hand[a]++;
+                hand[b]++;
+                total += composition_probability(single_deck, hand);
+            }
+        }
+        REQUIRE(std::fabs(total - 1.0) < 1e-14);
+
+        // Thirty-nine cards from an eight-deck shoe need log space.
+        std::array<std::uint32_t, 10> shoe;
+        for (std::size_t rank = 0; rank < 10; ++rank) {
+            shoe[rank] = single_deck[rank] * 8;
+        }
+        const std::array<std::uint32_t, 10> hand = {3, 3, 3, 3, 3, 3, 3, 3, 3, 12};
+        const double probability = composition_probability(shoe, hand);
+        double log_expected = -log_choose(416, 39);
+        for (std::size_t rank = 0; rank < 10; ++rank) {
+            log_expected += log_choose(shoe[rank], hand[rank]);
+        }
+        REQUIRE(std::fabs(std::log(probability) - log_expected) < 1e-12);
+    }
+}
+
+TEST_CASE("Binomial - Benchmarks", "[binomial][benchmark]") {
+    std::mt19937_64 rng(1);
+    std::vector<std::uint64_t> n(4096), k(4096);
+    for (std::size_t i = 0; i < n.size(); ++i) {
+        n[i] = rng() % 35;
+        k[i] = rng() % (n[i] + 1);
+    }
+    const int repetitions = 2000;
+    auto ns_per_value = [&](auto choose) {
+        std::uint64_t sum = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int rep = 0; rep < repetitions; ++rep) {
+            for (std::size_t i = 0; i < n.size(); ++i) {
+                sum += choose(n[i], k[i]);
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::make_pair(std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(n.size()) * repetitions), sum);
+    };
+
+    const auto table = ns_per_value([](std::uint64_t n, std::uint64_t k) { return *choose_u64(n, k); });
+    const auto ratio = ns_per_value([](std::uint64_t n, std::uint64_t k) {
+        return static_cast<std::uint64_t>(*factorial_u128(static_cast<int>(n))
+                                          / (*factorial_u128(static_cast<int>(k)) * *factorial_u128(static_cast<int>(n - k))));
+    });
+    const auto log_space = ns_per_value([](std::uint64_t n, std::uint64_t k) {
+        return static_cast<std::uint64_t>(std::llround(std::exp(log_choose(n, k))));
+    });
+    std::cout << "\nC(n, k) for n < 35: Pascal table " << table.first << " ns, 128-bit factorial ratio "
+              << ratio.first << " ns, exp(log_choose) " << log_space.first << " ns\n";
+    REQUIRE(table.second == ratio.second);
+
+    BENCHMARK("choose_u64(12, 5), table") {
+        return *choose_u64(opaque(12), opaque(5));
+    };
+    BENCHMARK("factorial(12) / (factorial(5) factorial(7)), recursive int") {
+        const int n = static_cast<int>(opaque(12));
+        const int k = static_cast<int>(opaque(5));
+        return factorial(n) / (factorial(k) * factorial(n - k));
+    };
+    BENCHMARK("choose_u64(416, 5), 128-bit") {
+        return *choose_u64(opaque(416), opaque(5));
+    };
+    BENCHMARK("multinomial of a 20-card hand over 10 ranks") {
+        std::array<std::uint32_t, 10> counts = {2, 2, 2, 2, 2, 2, 2, 2, 2, 2};
+        counts[0] = static_cast<std::uint32_t>(opaque(2));
+        return static_cast<std::uint64_t>(*multinomial(counts));
+    };
+    BENCHMARK("log_multinomial of an eight-deck shoe") {
+        std::array<std::uint32_t, 10> counts = {32, 32, 32, 32, 32, 32, 32, 32, 32, 128};
+        counts[0] = static_cast<std::uint32_t>(opaque(32));
+        return log_multinomial(counts);
+    };
+}
@@ -0,0 +1,165 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include "../src/bitset_deck.hpp"
+#include "../src/shuffle.hpp"
+
+namespace {
+    std::vector<bit_select> supported_selects() {
+        std::vector<bit_select> selects;
+        for (bit_select select : {bit_select::portable, bit_select::bmi2}) {
+            if (bit_select_supported(select)) selects.push_back(select);
+        }
+        return selects;
+    }
+
+    template <std::size_t Cards>
+    std::vector<std::uint16_t> deal_all(std::uint64_t seed, bit_select select) {
+        bitset_deck<Cards> deck(select);
+        default_engine rng(seed);
+        std::vector<std::uint16_t> dealt(Cards);
+        deck.deal(dealt, rng);
+        return dealt;
+    }
+}
+
+TEST_CASE("Bitset Deck - Correctness Tests", "[bitset_deck]") {
+    SECTION("Dealing every card yields each slot once") {
+        for (bit_select select : supported_selects()) {
+            std::vector<std::uint16_t> one_deck = deal_all<52>(1, select);
+            std::vector<std::uint16_t> shoe = deal_all<416>(2, select);
+            std::vector<std::uint16_t> odd = deal_all<1000>(3, select);
+            for (auto* dealt : {&one_deck, &shoe, &odd}) {
+                std::vector<std::uint16_t> expected(dealt->size());
+                std::iota(expected.begin(), expected.end(), std::uint16_t{0});
+                std::sort(dealt->begin(), dealt->end());
+                REQUIRE(*dealt == expected);
+            }
+        }
+    }
+
+    SECTION("Every select gives the same cards") {
+        for (bit_select select : supported_selects()) {
+            REQUIRE(deal_all<416>(4, select) == deal_all<416>(4, bit_select::portable));
+            REQUIRE(deal_all<64>(5, select) == deal_all<64>(5, bit_select::portable));
+        }
+    }
+
+    SECTION("Single draws and dealt batches track the remaining cards") {
+        bitset_deck<416> deck;
+        default_engine rng(6);
+        std::vector<std::uint16_t> dealt(60);
+        deck.deal(dealt, rng);
+        for (int i = 0; i < 40; ++i) {
+            dealt.push_back(deck.draw(rng));
+        }
+        REQUIRE(deck.remaining() == 316);
+        for (std::uint16_t slot : dealt) {
+            REQUIRE_FALSE(deck.contains(slot));
+        }
+        std::sort(dealt.begin(), dealt.end());
+        REQUIRE(std::adjacent_find(dealt.begin(), dealt.end()) == dealt.end());
+        deck.reset();
+        REQUIRE(deck.remaining() == 416);
+        REQUIRE(deck.contains(dealt[0]));
+    }
+
+    SECTION("Each deal position is uniform over the slots") {
+        for (bit_select select : supported_selects()) {
+            const int trials = 20800;
+            std::vector<int> counts(52 * 52, 0);
+            default_engine rng(7);
+            for (int trial = 0; trial < trials; ++trial) {
+                bitset_deck<52> deck(select);
+                std::vector<std::uint16_t> dealt(52);
+                deck.deal(std::span(dealt).first(20), rng);
+                for (std::size_t i = 20; i < 52; ++i) {
+                    dealt[i] = deck.draw(rng);
+                }
+                for (int position = 0; position < 52; ++position) {
+                    counts[dealt[position] * 52 + position]++;
+                }
+            }
+            const double expected = trials / 52.0;
+            double chi_squared = 0.0;
+            for (int count : counts) {
+                const double diff = count - expected;
+                chi_squared += diff * diff / expected;
+            }
+            REQUIRE(chi_squared < (52 * 52 - 1) * 1.2);
+        }
+    }
+}
+
+namespace {
+    // Cost of dealing depth cards from a fresh Cards-card deck: bitset deals
+    // per select, against pre-shuffling an array of slots with
+    // shuffle_fisher_yates and against shuffle_prefix.
+    template <std::size_t Cards>
+    void report_ns_per_deal(std::initializer_list<std::size_t> depths) {
+        default_engine rng(1);
+        const int repetitions = 200000;
+        std::vector<std::uint16_t> slots(Cards);
+        std::iota(slots.begin(), slots.end(), std::uint16_t{0});
+        std::vector<std::uint16_t> dealt(Cards);
+
+        auto ns_per_deal = [&](auto deal) {
+            std::uint32_t sum = 0;
+            deal(sum);
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int rep = 0; rep < repetitions; ++rep) {
+                deal(sum);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            REQUIRE(sum != 1);
+            return std::chrono::duration<double, std::nano>(end - start).count() / repetitions;
+        };
+
+        std::cout << "\nDeck Size: " << Cards << "\n";
+        for (std::size_t depth : depths) {
+            std::cout << "Depth " << depth << ":";
+            for (bit_select select : supported_selects()) {
+                const double bitset = ns_per_deal([&](std::uint32_t& sum) {
+                    bitset_deck<Cards> deck(select);
+                    deck.deal(std::span(dealt).first(depth), rng);
+                    sum += dealt[depth - 1];
+                });
+                std::cout << " bitset (" << bit_select_name(select) << ") " << bitset << " ns,";
+            }
+            const double pre_shuffled = ns_per_deal([&](std::uint32_t& sum) {
+                shuffle_fisher_yates(slots, rng);
+                sum += slots[depth - 1];
+            });
+            const double prefix = ns_per_deal([&](std::uint32_t& sum) {
+                sum += shuffle_prefix(slots, depth, rng)[depth - 1];
+            });
+            std::cout << " Fisher-Yates pre-shuffle " << pre_shuffled << " ns, shuffle_prefix " << prefix << " ns\n";
+        }
+    }
+}
+
+TEST_CASE("Bitset Deck - Deal Depths", "[bitset_deck][benchmark]") {
+    report_ns_per_deal<52>({5, 13, 26, 52});
+    report_ns_per_deal<416>({20, 40, 60, 104, 312});
+
+    default_engine rng(1);
+    std::vector<std::uint16_t> dealt(52);
+    BENCHMARK("bitset_deck<52> deal 52") {
+        bitset_deck<52> deck;
+        deck.deal(dealt, rng);
+        return dealt[51];
+    };
+    BENCHMARK("bitset_deck<52> draw 13") {
+        bitset_deck<52> deck;
+        std::uint32_t sum = 0;
+        for (int i = 0; i < 13; ++i) {
+            sum += deck.draw(rng);
+        }
+        return sum;
+    };
+}
@@ -0,0 +1,187 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include "../src/bounded_random.hpp"
+#include "../src/shuffle.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+    double chi_squared(const std::vector<int>& counts, double expected) {
+        double total = 0.0;
+        for (int count : counts) {
+            double diff = count - expected;
+            total += (diff * diff) / expected;
+        }
+        return total;
+    }
+
+    // The loop shuffle_fisher_yates used before bounded_random: one 32-bit
+    // draw and one division per card, biased towards low indices.
+    void fisher_yates_modulo(std::span<int> array, std::mt19937& rng) {
+        for (size_t i = array.size() - 1; i > 0; --i) {
+            size_t random_index = rng() % (i + 1);
+            std::swap(array[i], array[random_index]);
+        }
+    }
+
+    std::uint64_t read_cycle_counter() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+}
+
+TEST_CASE("Bounded Random - Correctness Tests", "[bounded_random]") {
+    std::mt19937 rng(12345);
+
+    SECTION("64-bit words are assembled from 32-bit engine outputs") {
+        std::mt19937 reference(12345);
+        std::uint64_t high = reference();
+        std::uint64_t low = reference();
+        REQUIRE(random_bits64(rng) == ((high << 32) | low));
+    }
+
+    SECTION("Results stay inside the range") {
+        const std::vector<std::uint64_t> ranges = {1, 2, 3, 52, 416, 1ull << 32, (1ull << 63) + 1, UINT64_MAX};
+        for (std::uint64_t range : ranges) {
+            for (int i = 0; i < 1000; ++i) {
+                REQUIRE(bounded_random(rng, range) < range);
+            }
+        }
+    }
+
+    SECTION("Batched draws stay inside their ranges") {
+        for (int i = 0; i < 1000; ++i) {
+            auto pair = bounded_random_batch<2>(rng, {1000003, 7});
+            REQUIRE(pair[0] < 1000003);
+            REQUIRE(pair[1] < 7);
+
+            auto descending = bounded_random_descending<6>(rng, 52);
+            for (size_t k = 0; k < descending.size(); ++k) {
+                REQUIRE(descending[k] < 52 - k);
+            }
+        }
+    }
+
+    SECTION("Batch limits keep the range product below 2^57") {
+        auto product_bits = [](std::uint64_t first_range, int count) {
+            double bits = 0.0;
+            for (int k = 0; k < count; ++k) {
+                bits += std::log2(static_cast<double>(first_range - k));
+            }
+            return bits;
+        };
+        REQUIRE(product_bits(max_batched_range<2>, 2) <= 57.0);
+        REQUIRE(product_bits(max_batched_range<3>, 3) <= 57.0);
+        REQUIRE(product_bits(max_batched_range<4>, 4) <= 57.0);
+    }
+}
+
+TEST_CASE("Bounded Random - Uniformity Tests", "[bounded_random][randomness]") {
+    std::mt19937 rng(2024);
+    const int DRAWS = 52000;
+
+    SECTION("Single draws are uniform") {
+        std::vector<int> counts(52, 0);
+        for (int i = 0; i < DRAWS; ++i) {
+            counts[bounded_random(rng, 52)]++;
+        }
+        REQUIRE(chi_squared(counts, DRAWS / 52.0) < 51 * 2.0);
+    }
+
+    SECTION("Every slot of a batch is uniform and independent of the others") {
+        std::vector<int> first(52, 0);
+        std::vector<int> last(47, 0);
+        std::vector<int> joint(52 * 47, 0);
+        for (int i = 0; i < DRAWS * 10; ++i) {
+            auto batch = bounded_random_descending<6>(rng, 52);
+            first[batch[0]]++;
+            last[batch[5]]++;
+            joint[batch[0] * 47 + batch[5]]++;
+        }
+        REQUIRE(chi_squared(first, DRAWS * 10 / 52.0) < 51 * 2.0);
+        REQUIRE(chi_squared(last, DRAWS * 10 / 47.0) < 46 * 2.0);
+        REQUIRE(chi_squared(joint, DRAWS * 10 / (52.0 * 47.0)) < (52 * 47 - 1) * 2.0);
+    }
+}
+
+TEST_CASE("Bounded Random - Performance Benchmarks", "[bounded_random][benchmark]") {
+    std::mt19937 rng(7);
+
+    BENCHMARK("modulo draws (52 ranges)") {
+        std::uint64_t sum = 0;
+        for (std::uint32_t range = 52; range > 1; --range) {
+            sum += rng() % range;
+        }
+        return sum;
+    };
+
+    BENCHMARK("bounded_random draws (52 ranges)") {
+        std::uint64_t sum = 0;
+        for (std::uint64_t range = 52; range > 1; --range) {
+            sum += bounded_random(rng, range);
+        }
+        return sum;
+    };
+
+    BENCHMARK("bounded_random_descending<6> draws (52 ranges)") {
+        std::uint64_t sum = 0;
+        std::uint64_t range = 52;
+        for (; range > 6; range -= 6) {
+            for (std::uint64_t index : bounded_random_descending<6>(rng, range)) {
+                sum += index;
+            }
+        }
+        for (std::uint64_t index : bounded_random_descending<5>(rng, range)) {
+            sum += index;
+        }
+        return sum;
+    };
+}
+
+TEST_CASE("Bounded Random - Cycles Per Card", "[bounded_random][benchmark]") {
+    const std::vector<size_t> deck_sizes = {52, 416, 10000000};
+
+    for (size_t deck_size : deck_sizes) {
+        SECTION("Deck size " + std::to_string(deck_size)) {
+            std::vector<int> deck(deck_size);
+            std::iota(deck.begin(), deck.end(), 0);
+            std::mt19937 rng(99);
+
+            const size_t repetitions = std::max<size_t>(1, 20000000 / deck_size);
+
+            auto cycles_per_card = [&](auto shuffle_func) {
+                shuffle_func(deck);
+                std::uint64_t start = read_cycle_counter();
+                for (size_t rep = 0; rep < repetitions; ++rep) {
+                    shuffle_func(deck);
+                }
+                std::uint64_t end = read_cycle_counter();
+                return static_cast<double>(end - start) / (repetitions * deck_size);
+            };
+
+            double modulo = cycles_per_card([&](std::vector<int>& cards) { fisher_yates_modulo(cards, rng); });
+            double batched = cycles_per_card([&](std::vector<int>& cards) { shuffle_fisher_yates(cards, rng); });
+
+            std::cout << "\nDeck Size: " << deck_size << "\n";
+            std::cout << "Modulo Fisher-Yates: " << modulo << " cycles/card\n";
+            std::cout << "Batched Fisher-Yates: " << batched << " cycles/card\n";
+
+            std::sort(deck.begin(), deck.end());
+            REQUIRE(deck.front() == 0);
+            REQUIRE(deck.back() == static_cast<int>(deck_size - 1));
+        }
+    }
+}
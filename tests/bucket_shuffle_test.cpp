@@ -0,0 +1,155 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <map>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include "../src/bucket_shuffle.hpp"
+
+namespace {
+    std::vector<int> iota_vector(size_t size) {
+        std::vector<int> values(size);
+        std::iota(values.begin(), values.end(), 0);
+        return values;
+    }
+}
+
+TEST_CASE("Bucket Shuffle - Correctness Tests", "[bucket_shuffle]") {
+    default_engine rng(3);
+
+    SECTION("Arrays that fit one bucket fall back to Fisher-Yates") {
+        std::vector<int> bucketed = iota_vector(1000);
+        std::vector<int> fisher_yates = iota_vector(1000);
+        default_engine same_rng = rng;
+        shuffle_bucketed(bucketed, rng);
+        shuffle_fisher_yates(fisher_yates, same_rng);
+        REQUIRE(bucketed == fisher_yates);
+    }
+
+    SECTION("Scattered and recursively split arrays stay permutations") {
+        for (size_t bucket_bytes : {bucket_shuffle_default_bytes, size_t{1024}, size_t{64}}) {
+            std::vector<int> values = iota_vector(300000);
+            shuffle_bucketed(values, rng, bucket_bytes);
+            REQUIRE(values != iota_vector(300000));
+            std::sort(values.begin(), values.end());
+            REQUIRE(values == iota_vector(300000));
+        }
+    }
+
+    SECTION("Equal engines give equal shuffles") {
+        std::vector<int> first = iota_vector(200000);
+        std::vector<int> second = iota_vector(200000);
+        shuffle_bucketed(first, default_engine(8));
+        shuffle_bucketed(second, default_engine(8));
+        REQUIRE(first == second);
+    }
+
+    SECTION("Edge cases") {
+        std::vector<int> empty;
+        REQUIRE_NOTHROW(shuffle_bucketed(empty));
+        std::vector<int> single = {42};
+        shuffle_bucketed(single, rng, 1);
+        REQUIRE(single == std::vector<int>{42});
+
+        // A bucket size of 0 falls back to the default rather than dividing by it.
+        std::vector<int> zero_bytes = iota_vector(200000);
+        std::vector<int> default_bytes = iota_vector(200000);
+        shuffle_bucketed(zero_bytes, default_engine(9), 0);
+        shuffle_bucketed(default_bytes, default_engine(9));
+        REQUIRE(zero_bytes == default_bytes);
+    }
+}
+
+TEST_CASE("Bucket Shuffle - Randomness Quality Tests", "[bucket_shuffle][randomness]") {
+    default_engine rng(17);
+
+    SECTION("Every permutation of 5 elements is equally likely") {
+        // Four-byte buckets force a scatter into 8 buckets plus recursion.
+        const int TRIALS = 120000;
+        std::map<std::vector<int>, int> counts;
+        for (int trial = 0; trial < TRIALS; ++trial) {
+            std::vector<int> values = iota_vector(5);
+            shuffle_bucketed(values, rng, sizeof(int));
+            counts[values]++;
+        }
+
+        REQUIRE(counts.size() == 120);
+        double expected = TRIALS / 120.0;
+        double chi_squared = 0.0;
+        for (const auto& [permutation, count] : counts) {
+            double diff = count - expected;
+            chi_squared += (diff * diff) / expected;
+        }
+        REQUIRE(chi_squared < 119 * 2.0);
+    }
+
+    SECTION("Card positions of a 52-card deck are uniform") {
+        const int TRIALS = 1000;
+        const int ARRAY_SIZE = 52;
+        std::vector<int> position_counts(ARRAY_SIZE * ARRAY_SIZE, 0);
+        for (int trial = 0; trial < TRIALS; ++trial) {
+            std::vector<int> deck = iota_vector(ARRAY_SIZE);
+            shuffle_bucketed(deck, rng, 16);
+            for (int pos = 0; pos < ARRAY_SIZE; ++pos) {
+                position_counts[deck[pos] * ARRAY_SIZE + pos]++;
+            }
+        }
+
+        double expected = static_cast<double>(TRIALS) / ARRAY_SIZE;
+        double chi_squared = 0.0;
+        for (int count : position_counts) {
+            double diff = count - expected;
+            chi_squared += (diff * diff) / expected;
+        }
+        REQUIRE(chi_squared < (ARRAY_SIZE * ARRAY_SIZE - 1) * 2.0);
+    }
+}
+
+namespace {
+    void report_ns_per_element(const std::vector<size_t>& sizes) {
+        default_engine rng(1);
+        for (size_t size : sizes) {
+            std::vector<std::uint32_t> values(size);
+            std::iota(values.begin(), values.end(), 0u);
+            const int repetitions = static_cast<int>(std::max<size_t>(1, 10000000 / size));
+
+            auto ns_per_element = [&](auto shuffle_func) {
+                shuffle_func(values);
+                auto start = std::chrono::high_resolution_clock::now();
+                for (int rep = 0; rep < repetitions; ++rep) {
+                    shuffle_func(values);
+                }
+                auto end = std::chrono::high_resolution_clock::now();
+                return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(size) * repetitions);
+            };
+
+            double fisher_yates = ns_per_element([&](std::vector<std::uint32_t>& v) { shuffle_fisher_yates(v, rng); });
+            double bucketed = ns_per_element([&](std::vector<std::uint32_t>& v) { shuffle_bucketed(v, rng); });
+
+            std::cout << "\nArray Size: " << size << "\n";
+            std::cout << "Fisher-Yates: " << fisher_yates << " ns/element\n";
+            std::cout << "Bucketed: " << bucketed << " ns/element\n";
+        }
+    }
+}
+
+TEST_CASE("Bucket Shuffle - Size Sweep", "[bucket_shuffle][benchmark]") {
+    report_ns_per_element({10000, 100000, 1000000, 10000000});
+
+    std::vector<int> values = iota_vector(10000000);
+    BENCHMARK("Fisher-Yates (size=10000000)") {
+        shuffle_fisher_yates(values);
+        return values[0];
+    };
+    BENCHMARK("Bucketed (size=10000000)") {
+        shuffle_bucketed(values);
+        return values[0];
+    };
+}
+
+TEST_CASE("Bucket Shuffle - Size Sweep up to 10^9", "[.][bucket_shuffle][benchmark][large]") {
+    report_ns_per_element({100000000, 1000000000});
+}
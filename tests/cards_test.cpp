@@ -0,0 +1,185 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include "../src/cards.hpp"
+
+static_assert(sizeof(shoe<8>) == 448);
+static_assert(alignof(deck) == 64);
+
+namespace {
+    // How many copies of each of the 52 cards a span holds.
+    std::array<int, 52> card_counts(std::span<const card> cards) {
+        std::array<int, 52> counts = {};
+        for (card c : cards) {
+            counts[c.index()]++;
+        }
+        return counts;
+    }
+}
+
+TEST_CASE("Cards - Encoding", "[cards]") {
+    for (int suit = 0; suit < card::suits; ++suit) {
+        for (int rank = 0; rank < card::ranks; ++rank) {
+            const card c(rank, static_cast<card_suit>(suit));
+            REQUIRE(c.rank() == rank);
+            REQUIRE(c.suit() == static_cast<card_suit>(suit));
+            REQUIRE(c.index() == suit * 13 + rank);
+            REQUIRE(c.code() < 64);
+        }
+    }
+    REQUIRE(card(12, card_suit::spades) != card(12, card_suit::hearts));
+}
+
+TEST_CASE("Cards - Shoe Shuffling and Dealing", "[cards]") {
+    default_engine rng(1);
+
+    SECTION("A new shoe holds each card once per deck, in order") {
+        shoe<8> cards;
+        REQUIRE(cards.remaining() == 416);
+        REQUIRE(card_counts(cards.cards()) == std::array<int, 52>{8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+                                                                  8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+                                                                  8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+                                                                  8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8});
+        REQUIRE(cards.cards()[0] == card(0, card_suit::clubs));
+        REQUIRE(cards.cards()[51] == card(12, card_suit::spades));
+    }
+
+    SECTION("Shuffling and dealing keep the multiset of cards") {
+        shoe<8> cards;
+        const auto expected = card_counts(cards.cards());
+        cards.shuffle(rng);
+        REQUIRE(card_counts(cards.cards()) == expected);
+
+        std::span<const card> round = cards.deal(60, rng);
+        REQUIRE(round.size() == 60);
+        REQUIRE(cards.dealt() == 60);
+        for (int i = 0; i < 40; ++i) {
+            cards.deal(rng);
+        }
+        REQUIRE(cards.dealt_cards().size() == 100);
+        REQUIRE(cards.deal(1000, rng).size() == 316);
+        REQUIRE(cards.empty());
+        REQUIRE(card_counts(cards.cards()) == expected);
+
+        cards.collect();
+        REQUIRE(cards.remaining() == 416);
+    }
+
+    SECTION("Single deals and batch deals agree on a fresh deck") {
+        deck single;
+        deck batch;
+        default_engine single_rng(2);
+        default_engine batch_rng(2);
+        std::span<const card> dealt = batch.deal(52, batch_rng);
+        for (size_t i = 0; i < 52; ++i) {
+            // bounded_random and the batched draws use different words, so
+            // compare the sets rather than the orders.
+            single.deal(single_rng);
+        }
+        REQUIRE(card_counts(single.cards()) == card_counts(dealt));
+    }
+
+    SECTION("Each position of a collected deck is dealt uniformly") {
+        // Dealing continues from the previous round's order, as at a table.
+        const int trials = 52000;
+        std::vector<int> counts(52 * 52, 0);
+        deck cards;
+        for (int trial = 0; trial < trials; ++trial) {
+            cards.collect();
+            for (int position = 0; position < 52; ++position) {
+                counts[cards.deal(rng).index() * 52 + position]++;
+            }
+        }
+        const double expected = trials / 52.0;
+        double chi_squared = 0.0;
+        for (int count : counts) {
+            const double diff = count - expected;
+            chi_squared += diff * diff / expected;
+        }
+        REQUIRE(chi_squared < (52 * 52 - 1) * 1.2);
+    }
+}
+
+namespace {
+    // Deals a round of 60 cards from every shoe of a table farm, stored
+    // either compactly or as int, and reports ns per shoe.
+    void report_ns_per_shoe(size_t shoe_count) {
+        default_engine rng(1);
+        std::vector<shoe<8>> compact(shoe_count);
+        std::vector<int> wide(shoe_count * 416);
+        for (size_t i = 0; i < wide.size(); ++i) {
+            wide[i] = compact[i / 416].cards()[i % 416].index();
+        }
+        const int repetitions = static_cast<int>(std::max<size_t>(1, 4000000 / shoe_count));
+
+        auto ns_per_shoe = [&](auto round) {
+            round();
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int rep = 0; rep < repetitions; ++rep) {
+                round();
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(shoe_count) * repetitions);
+        };
+
+        const double compact_deal = ns_per_shoe([&] {
+            for (auto& cards : compact) {
+                cards.collect();
+                cards.deal(60, rng);
+            }
+        });
+        const double wide_deal = ns_per_shoe([&] {
+            for (size_t s = 0; s < shoe_count; ++s) {
+                shuffle_prefix(std::span<int>(wide).subspan(s * 416, 416), 60, rng);
+            }
+        });
+        const double compact_shuffle = ns_per_shoe([&] {
+            for (auto& cards : compact) {
+                cards.shuffle(rng);
+            }
+        });
+        const double wide_shuffle = ns_per_shoe([&] {
+            for (size_t s = 0; s < shoe_count; ++s) {
+                shuffle_fisher_yates(std::span<int>(wide).subspan(s * 416, 416), rng);
+            }
+        });
+
+        std::cout << "\nShoes: " << shoe_count << " (compact " << shoe_count * sizeof(shoe<8>) / 1024
+                  << " KiB, int " << wide.size() * sizeof(int) / 1024 << " KiB)\n";
+        std::cout << "Deal 60, compact: " << compact_deal << " ns/shoe, int: " << wide_deal << " ns/shoe\n";
+        std::cout << "Full shuffle, compact: " << compact_shuffle << " ns/shoe, int: " << wide_shuffle << " ns/shoe\n";
+    }
+}
+
+TEST_CASE("Cards - Compact vs int Shoes", "[cards][benchmark]") {
+    // One shoe, then table farms from L2-sized to past the L2 for int only.
+    report_ns_per_shoe(1);
+    report_ns_per_shoe(1024);
+    report_ns_per_shoe(16384);
+
+    default_engine rng(1);
+    deck cards;
+    BENCHMARK("deck::shuffle") {
+        cards.shuffle(rng);
+        return cards.cards()[0];
+    };
+    BENCHMARK("deck::deal(52)") {
+        cards.collect();
+        return cards.deal(52, rng)[0];
+    };
+    std::vector<int> wide(52);
+    std::iota(wide.begin(), wide.end(), 0);
+    BENCHMARK("Fisher-Yates over int (size=52)") {
+        shuffle_fisher_yates(wide, rng);
+        return wide[0];
+    };
+}
+
+TEST_CASE("Cards - DRAM-Sized Table Farms", "[.][cards][benchmark][large]") {
+    report_ns_per_shoe(131072);
+}
@@ -0,0 +1,190 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <map>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include "../src/deck_batch.hpp"
+#include "../src/simd_random.hpp"
+
+namespace {
+    // deck_count ordered decks of deck_size cards, position-major.
+    std::vector<std::uint8_t> ordered_block(size_t deck_count, size_t deck_size) {
+        std::vector<std::uint8_t> cards(deck_count * deck_size);
+        for (size_t position = 0; position < deck_size; ++position) {
+            std::fill_n(cards.begin() + position * deck_count, deck_count, static_cast<std::uint8_t>(position % 52));
+        }
+        return cards;
+    }
+
+    std::vector<std::uint8_t> deck_of(const std::vector<std::uint8_t>& cards, size_t deck_count, size_t deck) {
+        std::vector<std::uint8_t> result;
+        for (size_t position = 0; position < cards.size() / deck_count; ++position) {
+            result.push_back(cards[position * deck_count + deck]);
+        }
+        return result;
+    }
+}
+
+TEST_CASE("Deck Batch - Correctness Tests", "[deck_batch]") {
+    default_engine rng(1);
+
+    SECTION("Every deck stays a permutation") {
+        for (size_t deck_count : {1, 7, 256, 1000}) {
+            for (size_t deck_size : {1, 2, 52, 312}) {
+                std::vector<std::uint8_t> cards = ordered_block(deck_count, deck_size);
+                shuffle_deck_block(cards, deck_count, rng);
+                std::vector<std::uint8_t> expected = deck_of(ordered_block(1, deck_size), 1, 0);
+                std::sort(expected.begin(), expected.end());
+                for (size_t deck = 0; deck < deck_count; ++deck) {
+                    std::vector<std::uint8_t> shuffled = deck_of(cards, deck_count, deck);
+                    std::sort(shuffled.begin(), shuffled.end());
+                    REQUIRE(shuffled == expected);
+                }
+            }
+        }
+    }
+
+    SECTION("Decks in a block are shuffled independently") {
+        std::vector<std::uint8_t> cards = ordered_block(1000, 52);
+        shuffle_deck_block(cards, 1000, rng);
+        REQUIRE(deck_of(cards, 1000, 0) != deck_of(cards, 1000, 1));
+        REQUIRE(deck_of(cards, 1000, 255) != deck_of(cards, 1000, 256));
+    }
+
+    SECTION("Every supported backend gives the same block") {
+        std::vector<std::uint8_t> expected = ordered_block(700, 130);
+        shuffle_deck_block(expected, 700, default_engine(6), simd_backend::scalar);
+        for (simd_backend backend : {simd_backend::avx2, simd_backend::avx512}) {
+            if (!simd_backend_supported(backend)) continue;
+            INFO("backend " << simd_backend_name(backend));
+            std::vector<std::uint8_t> cards = ordered_block(700, 130);
+            shuffle_deck_block(cards, 700, default_engine(6), backend);
+            REQUIRE(cards == expected);
+        }
+    }
+
+    SECTION("Same engine state gives the same block with any engine") {
+        std::vector<std::uint8_t> first = ordered_block(600, 52);
+        std::vector<std::uint8_t> second = ordered_block(600, 52);
+        shuffle_deck_block(first, 600, xoshiro256ss_x8(4));
+        shuffle_deck_block(second, 600, xoshiro256ss_x8(4));
+        REQUIRE(first == second);
+    }
+
+    SECTION("Empty block") {
+        std::vector<std::uint8_t> cards;
+        REQUIRE_NOTHROW(shuffle_deck_block(cards, 0));
+    }
+}
+
+TEST_CASE("Deck Batch - Randomness Quality Tests", "[deck_batch][randomness]") {
+    SECTION("Every permutation of 4 cards is equally likely") {
+        // Decks span a full and a partial tile.
+        const size_t DECKS = 300;
+        const int BLOCKS = 400;
+        std::map<int, int> totals;
+        xoshiro256ss_x8 rng(8);
+        for (int block = 0; block < BLOCKS; ++block) {
+            std::vector<std::uint8_t> cards = ordered_block(DECKS, 4);
+            shuffle_deck_block(cards, DECKS, rng);
+            for (size_t deck = 0; deck < DECKS; ++deck) {
+                int code = 0;
+                for (std::uint8_t card : deck_of(cards, DECKS, deck)) {
+                    code = code * 4 + card;
+                }
+                totals[code]++;
+            }
+        }
+
+        REQUIRE(totals.size() == 24);
+        double expected = static_cast<double>(DECKS) * BLOCKS / 24;
+        double chi_squared = 0.0;
+        for (const auto& [code, count] : totals) {
+            double diff = count - expected;
+            chi_squared += (diff * diff) / expected;
+        }
+        REQUIRE(chi_squared < 23 * 2.0);
+    }
+
+    SECTION("Card positions of 52-card decks are uniform") {
+        const size_t DECKS = 1000;
+        const int ARRAY_SIZE = 52;
+        std::vector<std::uint8_t> cards = ordered_block(DECKS, ARRAY_SIZE);
+        shuffle_deck_block(cards, DECKS, default_engine(2));
+
+        std::vector<int> position_counts(ARRAY_SIZE * ARRAY_SIZE, 0);
+        for (int pos = 0; pos < ARRAY_SIZE; ++pos) {
+            for (size_t deck = 0; deck < DECKS; ++deck) {
+                position_counts[cards[pos * DECKS + deck] * ARRAY_SIZE + pos]++;
+            }
+        }
+
+        double expected = static_cast<double>(DECKS) / ARRAY_SIZE;
+        double chi_squared = 0.0;
+        for (int count : position_counts) {
+            double diff = count - expected;
+            chi_squared += (diff * diff) / expected;
+        }
+        REQUIRE(chi_squared < (ARRAY_SIZE * ARRAY_SIZE - 1) * 2.0);
+    }
+}
+
+namespace {
+    template <typename Shuffle>
+    double decks_per_second(size_t deck_count, Shuffle shuffle) {
+        shuffle();
+        const int repetitions = 5;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int rep = 0; rep < repetitions; ++rep) {
+            shuffle();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return static_cast<double>(deck_count) * repetitions / std::chrono::duration<double>(end - start).count();
+    }
+}
+
+TEST_CASE("Deck Batch - Decks Per Second", "[deck_batch][benchmark]") {
+    const size_t BLOCK_DECKS = 256;
+    const size_t DECKS = BLOCK_DECKS * 4096;
+    for (size_t deck_size : {52, 312}) {
+        std::vector<std::uint8_t> block;
+        for (size_t first = 0; first < DECKS; first += BLOCK_DECKS) {
+            std::vector<std::uint8_t> one_block = ordered_block(BLOCK_DECKS, deck_size);
+            block.insert(block.end(), one_block.begin(), one_block.end());
+        }
+        std::vector<std::uint8_t> decks(DECKS * deck_size);
+        for (size_t deck = 0; deck < DECKS; ++deck) {
+            std::iota(decks.begin() + deck * deck_size, decks.begin() + (deck + 1) * deck_size, 0);
+        }
+        default_engine loop_rng(1);
+        default_engine block_rng(1);
+        xoshiro256ss_x8 simd_rng(1);
+
+        double loop = decks_per_second(DECKS, [&] {
+            for (size_t deck = 0; deck < DECKS; ++deck) {
+                shuffle_fisher_yates(std::span<std::uint8_t>(decks.data() + deck * deck_size, deck_size), loop_rng);
+            }
+        });
+        // Blocks of BLOCK_DECKS decks, each block position-major.
+        auto shuffle_blocks = [&](auto& rng, simd_backend backend) {
+            const size_t block_size = BLOCK_DECKS * deck_size;
+            for (size_t first = 0; first < block.size(); first += block_size) {
+                shuffle_deck_block(std::span<std::uint8_t>(block.data() + first, block_size), BLOCK_DECKS, rng, backend);
+            }
+        };
+        double batched = decks_per_second(DECKS, [&] { shuffle_blocks(block_rng, best_simd_backend()); });
+
+        std::cout << "\nDeck Size: " << deck_size << " (" << DECKS << " decks, one core)\n";
+        std::cout << "Fisher-Yates loop: " << loop / 1e6 << " M decks/s\n";
+        std::cout << "Batched " << simd_backend_name(best_simd_backend()) << ", xoshiro256**: " << batched / 1e6 << " M decks/s\n";
+        for (simd_backend backend : {simd_backend::scalar, simd_backend::avx2, simd_backend::avx512}) {
+            if (!simd_backend_supported(backend)) continue;
+            double batched_simd = decks_per_second(DECKS, [&] { shuffle_blocks(simd_rng, backend); });
+            std::cout << "Batched " << simd_backend_name(backend) << ", xoshiro256**x8: " << batched_simd / 1e6 << " M decks/s\n";
+        }
+    }
+}
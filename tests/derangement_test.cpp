@@ -0,0 +1,230 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <cstdint>
+#include <iostream>
+#include "../src/derangement.hpp"
+
+namespace {
+    std::vector<int> iota_vector(size_t size) {
+        std::vector<int> values(size);
+        std::iota(values.begin(), values.end(), 0);
+        return values;
+    }
+
+    bool is_single_cycle(const std::vector<int>& values) {
+        size_t length = 0;
+        size_t position = 0;
+        do {
+            position = static_cast<size_t>(values[position]);
+            ++length;
+        } while (position != 0 && length <= values.size());
+        return length == values.size();
+    }
+
+    bool is_derangement(const std::vector<int>& values) {
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (values[i] == static_cast<int>(i)) return false;
+        }
+        return true;
+    }
+
+    // Chi-squared of the outcomes of shuffling 0..size-1 against a uniform
+    // distribution over the cells outcomes that qualify.
+    template <typename Shuffle, typename Qualifies>
+    double chi_squared_over_outcomes(size_t size, size_t cells, int trials, Shuffle shuffle, Qualifies qualifies) {
+        std::map<std::vector<int>, int> counts;
+        for (int trial = 0; trial < trials; ++trial) {
+            std::vector<int> values = iota_vector(size);
+            shuffle(values);
+            if (!qualifies(values)) return 1e9;
+            counts[values]++;
+        }
+        if (counts.size() != cells) return 1e9;
+        const double expected = static_cast<double>(trials) / cells;
+        double chi_squared = 0.0;
+        for (const auto& [outcome, count] : counts) {
+            const double diff = count - expected;
+            chi_squared += diff * diff / expected;
+        }
+        return chi_squared;
+    }
+
+    // What the table assignment jobs did before: retry until nobody keeps
+    // their own seat.
+    template <typename URBG>
+    void derangement_by_retrying(std::vector<int>& values, URBG& rng) {
+        const std::vector<int> original = values;
+        while (true) {
+            values = original;
+            shuffle_fisher_yates(std::span(values), rng);
+            bool fixed_point = false;
+            for (size_t i = 0; i < values.size(); ++i) {
+                fixed_point |= values[i] == original[i];
+            }
+            if (!fixed_point) return;
+        }
+    }
+}
+
+TEST_CASE("Derangement - Correctness Tests", "[derangement]") {
+    SECTION("Derangement counts") {
+        REQUIRE(shuffle_detail::derangement_counts[4] == 9u);
+        REQUIRE(shuffle_detail::derangement_counts[5] == 44u);
+        REQUIRE(shuffle_detail::derangement_counts[20] == 895014631192902121u);
+        // D(34) = 108610077126170304674801654684367969729.
+        const unsigned __int128 last = shuffle_detail::derangement_counts[34];
+        REQUIRE(static_cast<std::uint64_t>(last >> 64) == 5887764078700601819u);
+        REQUIRE(static_cast<std::uint64_t>(last) == 11961622696523980225u);
+    }
+
+    SECTION("Cycle-closing coins are the exact chances in binary") {
+        // The chance times 2^64 fits in 128 bits while (u - 1) D(u - 2) fits in 64.
+        for (size_t u = 3; u <= 21; ++u) {
+            const unsigned __int128 chance = ((u - 1) * shuffle_detail::derangement_counts[u - 2]) << 64;
+            const unsigned __int128 count = shuffle_detail::derangement_counts[u];
+            REQUIRE(shuffle_detail::derangement_coins[u].fraction == chance / count);
+            REQUIRE(shuffle_detail::derangement_coins[u].rest == chance % count);
+        }
+        REQUIRE(shuffle_detail::derangement_coins[2].fraction == UINT64_MAX);
+        REQUIRE(shuffle_detail::derangement_coins[3].fraction == 0);
+        for (size_t u = 4; u <= shuffle_detail::derangement_exact_limit; ++u) {
+            REQUIRE(shuffle_detail::derangement_coins[u].rest < shuffle_detail::derangement_counts[u]);
+        }
+
+        default_engine rng(5);
+        for (size_t u : {2, 5, 20, 21, 34}) {
+            const unsigned __int128 count = shuffle_detail::derangement_counts[u];
+            bool upper_half = false;
+            for (int trial = 0; trial < 200; ++trial) {
+                const unsigned __int128 value = shuffle_detail::bounded_random_wide(rng, count);
+                REQUIRE(value < count);
+                upper_half |= value >= count / 2;
+            }
+            REQUIRE((upper_half || count == 1));
+        }
+    }
+
+    SECTION("Sattolo yields a single cycle") {
+        // Sizes cover every batch width of the schedule.
+        for (size_t size : {2, 3, 4, 5, 6, 7, 52, 416, 20000, 300000}) {
+            std::vector<int> values = iota_vector(size);
+            shuffle_sattolo(values, default_engine(size));
+            REQUIRE(is_single_cycle(values));
+        }
+        std::vector<int> empty;
+        shuffle_sattolo(empty);
+        std::vector<int> one = {7};
+        shuffle_sattolo(one);
+        REQUIRE(one[0] == 7);
+    }
+
+    SECTION("Derangement leaves no fixed point") {
+        default_engine rng(1);
+        for (size_t size : {2, 3, 4, 5, 6, 7, 21, 22, 34, 35, 52, 416, 300000}) {
+            for (int trial = 0; trial < 20; ++trial) {
+                std::vector<int> values = iota_vector(size);
+                shuffle_derangement(values, rng);
+                REQUIRE(is_derangement(values));
+                std::vector<int> sorted = values;
+                std::sort(sorted.begin(), sorted.end());
+                REQUIRE(sorted == iota_vector(size));
+            }
+        }
+        std::vector<int> one = {7};
+        shuffle_derangement(one);
+        REQUIRE(one[0] == 7);
+    }
+}
+
+TEST_CASE("Derangement - Statistical Validation", "[derangement][randomness]") {
+    default_engine rng(2);
+
+    SECTION("Sattolo is uniform over the 24 cycles of 5 elements") {
+        double chi_squared = chi_squared_over_outcomes(5, 24, 48000,
+            [&](std::vector<int>& values) { shuffle_sattolo(values, rng); }, is_single_cycle);
+        REQUIRE(chi_squared < 23 * 2.0);
+    }
+
+    SECTION("Sattolo is uniform over the 720 cycles of 7 elements") {
+        double chi_squared = chi_squared_over_outcomes(7, 720, 144000,
+            [&](std::vector<int>& values) { shuffle_sattolo(values, rng); }, is_single_cycle);
+        REQUIRE(chi_squared < 719 * 1.5);
+    }
+
+    SECTION("Derangements of 4 and 5 elements are uniform") {
+        double four = chi_squared_over_outcomes(4, 9, 36000,
+            [&](std::vector<int>& values) { shuffle_derangement(values, rng); }, is_derangement);
+        REQUIRE(four < 8 * 2.5);
+        double five = chi_squared_over_outcomes(5, 44, 88000,
+            [&](std::vector<int>& values) { shuffle_derangement(values, rng); }, is_derangement);
+        REQUIRE(five < 43 * 2.0);
+    }
+
+    SECTION("The exact cycle-closing coin above 64 bits has the right odds") {
+        for (size_t open : {21, 27, 34}) {
+            const int trials = 400000;
+            int closed = 0;
+            for (int trial = 0; trial < trials; ++trial) {
+                closed += shuffle_detail::derangement_closes_cycle(rng, open);
+            }
+            const double p = static_cast<double>((open - 1) * shuffle_detail::derangement_counts[open - 2])
+                / static_cast<double>(shuffle_detail::derangement_counts[open]);
+            const double sigma = std::sqrt(trials * p * (1 - p));
+            REQUIRE(std::fabs(closed - trials * p) < 5 * sigma);
+        }
+    }
+
+    SECTION("Derangements of 7 elements are uniform") {
+        double chi_squared = chi_squared_over_outcomes(7, 1854, 370800,
+            [&](std::vector<int>& values) { shuffle_derangement(values, rng); }, is_derangement);
+        REQUIRE(chi_squared < 1853 * 1.3);
+    }
+}
+
+TEST_CASE("Derangement - Throughput", "[derangement][benchmark]") {
+    default_engine rng(1);
+    for (size_t size : {8, 52, 416, 10000, 1000000}) {
+        std::vector<int> values = iota_vector(size);
+        const int repetitions = static_cast<int>(std::max<size_t>(3, 5000000 / size));
+
+        auto ns_per_element = [&](auto shuffle) {
+            shuffle();
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int rep = 0; rep < repetitions; ++rep) {
+                shuffle();
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(size) * repetitions);
+        };
+
+        const double fisher_yates = ns_per_element([&] { shuffle_fisher_yates(std::span(values), rng); });
+        const double sattolo = ns_per_element([&] { shuffle_sattolo(values, rng); });
+        const double derangement = ns_per_element([&] { shuffle_derangement(values, rng); });
+        const double retrying = ns_per_element([&] { derangement_by_retrying(values, rng); });
+        std::cout << "\nElements: " << size << "\n"
+                  << "Fisher-Yates: " << fisher_yates << " ns/element\n"
+                  << "Sattolo: " << sattolo << " ns/element\n"
+                  << "Derangement: " << derangement << " ns/element, retrying Fisher-Yates: " << retrying
+                  << " ns/element (" << retrying / derangement << "x)\n";
+    }
+
+    std::vector<int> table = iota_vector(52);
+    BENCHMARK("shuffle_sattolo (52 seats)") {
+        shuffle_sattolo(table, rng);
+        return table[0];
+    };
+    BENCHMARK("shuffle_derangement (52 seats)") {
+        shuffle_derangement(table, rng);
+        return table[0];
+    };
+    BENCHMARK("Retrying Fisher-Yates (52 seats)") {
+        derangement_by_retrying(table, rng);
+        return table[0];
+    };
+}
@@ -3,8 +3,75 @@
 #include <catch2/benchmark/catch_constructor.hpp>
 #include <catch2/generators/catch_generators_range.hpp>
 
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
 #include "../src/factorial.hpp"
 
+namespace {
+    // What factorial() would be over 64 bits, for the benchmarks.
+    std::uint64_t recursive_factorial_u64( int number ) {
+        return number <= 1 ? 1 : recursive_factorial_u64( number - 1 ) * static_cast<std::uint64_t>( number );
+    }
+
+    std::string decimal( unsigned __int128 value ) {
+        std::string digits;
+        do {
+            digits.insert( digits.begin(), static_cast<char>( '0' + static_cast<int>( value % 10 ) ) );
+            value /= 10;
+        } while ( value != 0 );
+        return digits;
+    }
+
+    // Schoolbook product with a carry after every limb, as a reference.
+    std::vector<std::uint32_t> reference_multiply( const std::vector<std::uint32_t>& a, const std::vector<std::uint32_t>& b ) {
+        std::vector<std::uint32_t> out( a.size() + b.size(), 0 );
+        for ( std::size_t i = 0; i < a.size(); ++i ) {
+            std::uint64_t carry = 0;
+            for ( std::size_t j = 0; j < b.size() || carry != 0; ++j ) {
+                const std::uint64_t value = out[i + j] + carry + ( j < b.size() ? std::uint64_t{a[i]} * b[j] : 0 );
+                out[i + j] = static_cast<std::uint32_t>( value % factorial_limb_base );
+                carry = value / factorial_limb_base;
+            }
+        }
+        while ( !out.empty() && out.back() == 0 ) {
+            out.pop_back();
+        }
+        return out;
+    }
+
+    std::vector<std::uint32_t> random_limbs( std::size_t size, std::mt19937_64& rng ) {
+        std::vector<std::uint32_t> limbs( size );
+        for ( std::uint32_t& limb : limbs ) {
+            limb = static_cast<std::uint32_t>( rng() % factorial_limb_base );
+        }
+        limbs.back() = std::max<std::uint32_t>( limbs.back(), 1 );
+        return limbs;
+    }
+
+    // 1 * 2 * ... * number, one small multiplication at a time.
+    std::vector<std::uint32_t> sequential_factorial( std::uint32_t number ) {
+        std::vector<std::uint32_t> result = { 1 };
+        for ( std::uint32_t factor = 2; factor <= number; ++factor ) {
+            result = reference_multiply( result, { factor } );
+        }
+        return result;
+    }
+
+    // Keeps the argument out of the optimizer's sight, so every benchmark
+    // does the work at run time.
+    int opaque( int number ) {
+        volatile int value = number;
+        return value;
+    }
+}
+
 TEST_CASE( "it computes the factorial of different numbers" ) {
     REQUIRE( factorial(0) == 1 );
     REQUIRE( factorial(1) == 1 );
@@ -13,20 +80,260 @@ TEST_CASE( "it computes the factorial of different numbers" ) {
     REQUIRE( factorial(10) == 3628800 );
 }
 
-TEST_CASE("benchmarking the factorial function") {
-    BENCHMARK("factorial(20)") {
-        return factorial(20);
+TEST_CASE( "the checked factorials match the recursive one and report overflow" ) {
+    static_assert( *factorial_u64(5) == 120 );
+    static_assert( !factorial_u64(21).has_value() );
+
+    for ( int number = 0; number <= 12; ++number ) {
+        REQUIRE( *factorial_u64(number) == static_cast<std::uint64_t>( factorial(number) ) );
+    }
+    for ( int number = 0; number <= factorial_u64_max; ++number ) {
+        REQUIRE( *factorial_u128(number) == *factorial_u64(number) );
+    }
+    REQUIRE( *factorial_u64(20) == 2432902008176640000ULL );
+    REQUIRE( decimal( *factorial_u128(25) ) == "15511210043330985984000000" );
+    REQUIRE( decimal( *factorial_u128(34) ) == "295232799039604140847618609643520000000" );
+
+    REQUIRE( factorial_u64(21).error() == factorial_error::overflow );
+    REQUIRE( factorial_u128(35).error() == factorial_error::overflow );
+    REQUIRE( factorial_u64(-1).error() == factorial_error::negative );
+    REQUIRE( factorial_u128(-1).error() == factorial_error::negative );
+}
+
+TEST_CASE( "the big factorial is exact" ) {
+    REQUIRE( factorial_decimal(0) == "1" );
+    REQUIRE( factorial_decimal(1) == "1" );
+    REQUIRE( factorial_decimal(20) == "2432902008176640000" );
+    REQUIRE( factorial_decimal(52) == "80658175170943878571660636856403766975289505440883277824000000000000" );
+
+    const std::string deck_of_416 = factorial_decimal(416);
+    REQUIRE( deck_of_416.size() == 911 );
+    REQUIRE( deck_of_416.starts_with( "384631338771995749028435389801" ) );
+
+    int digit_sum = 0;
+    for ( char digit : factorial_decimal(1000) ) {
+        digit_sum += digit - '0';
+    }
+    REQUIRE( digit_sum == 10539 );
+
+    for ( std::uint32_t number : { 2u, 3u, 31u, 100u, 1000u, 5000u } ) {
+        REQUIRE( factorial_limbs(number) == sequential_factorial(number) );
+    }
+    const std::string big = factorial_decimal(10000, 1);
+    REQUIRE( big.size() == 35660 );
+    REQUIRE( big.starts_with( "28462596809170545189" ) );
+    REQUIRE( factorial_limbs(30000, 1) == factorial_limbs(30000, 4) );
+}
+
+TEST_CASE( "big multiplication matches the schoolbook reference" ) {
+    std::mt19937_64 rng( 1 );
+    // Sizes around the Karatsuba threshold, lopsided operands and the
+    // parallel split.
+    const std::vector<std::pair<std::size_t, std::size_t>> sizes = {
+        { 1, 1 }, { 39, 39 }, { 40, 40 }, { 41, 80 }, { 100, 1000 }, { 777, 1500 }, { 2500, 2600 },
+    };
+    for ( auto [a_size, b_size] : sizes ) {
+        const std::vector<std::uint32_t> a = random_limbs( a_size, rng );
+        const std::vector<std::uint32_t> b = random_limbs( b_size, rng );
+        const std::vector<std::uint32_t> expected = reference_multiply( a, b );
+        REQUIRE( factorial_detail::multiply( a, b ) == expected );
+        REQUIRE( factorial_detail::multiply( b, a, 4 ) == expected );
+    }
+    const std::vector<std::uint32_t> nines( 300, factorial_limb_base - 1 );
+    REQUIRE( factorial_detail::multiply( nines, nines ) == reference_multiply( nines, nines ) );
+    REQUIRE( factorial_detail::to_decimal( std::vector<std::uint32_t>{ 7, 0, 12 } ) == "12000000000000000007" );
+}
+
+TEST_CASE( "benchmarking the factorial function", "[benchmark]" ) {
+    // int overflows past 12!, so the recursive version is measured at 12
+    // and over 64 bits at 20.
+    BENCHMARK( "recursive factorial(12)" ) {
+        return factorial( opaque(12) );
+    };
+
+    BENCHMARK( "recursive 64-bit factorial(20)" ) {
+        return recursive_factorial_u64( opaque(20) );
+    };
+
+    BENCHMARK( "factorial_u64(12)" ) {
+        return *factorial_u64( opaque(12) );
+    };
+
+    BENCHMARK( "factorial_u64(20)" ) {
+        return *factorial_u64( opaque(20) );
+    };
+
+    BENCHMARK( "factorial_u128(25)" ) {
+        return static_cast<std::uint64_t>( *factorial_u128( opaque(25) ) );
+    };
+
+    BENCHMARK( "factorial_u128(30)" ) {
+        return static_cast<std::uint64_t>( *factorial_u128( opaque(30) ) );
+    };
+
+    BENCHMARK( "factorial_u128(34)" ) {
+        return static_cast<std::uint64_t>( *factorial_u128( opaque(34) ) );
+    };
+}
+
+namespace {
+    void report_big_factorials( const std::vector<std::uint32_t>& numbers ) {
+        for ( std::uint32_t number : numbers ) {
+            auto start = std::chrono::high_resolution_clock::now();
+            const std::vector<std::uint32_t> limbs = factorial_limbs( number );
+            auto middle = std::chrono::high_resolution_clock::now();
+            const std::string digits = factorial_detail::to_decimal( limbs );
+            auto end = std::chrono::high_resolution_clock::now();
+            std::cout << number << "!: " << digits.size() << " digits, "
+                      << std::chrono::duration<double, std::milli>( middle - start ).count() << " ms, decimal output "
+                      << std::chrono::duration<double, std::milli>( end - middle ).count() << " ms\n";
+        }
+    }
+}
+
+TEST_CASE( "benchmarking the big factorial", "[benchmark]" ) {
+    std::cout << "\n";
+    report_big_factorials( { 1000, 10000, 100000 } );
+
+    // The product of 1 .. n one factor at a time, for comparison.
+    auto start = std::chrono::high_resolution_clock::now();
+    const std::vector<std::uint32_t> sequential = sequential_factorial( 10000 );
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "10000! one factor at a time: "
+              << std::chrono::duration<double, std::milli>( end - start ).count() << " ms\n";
+
+    BENCHMARK( "factorial_limbs(1000)" ) {
+        return factorial_limbs( static_cast<std::uint32_t>( opaque(1000) ) ).size();
     };
 
-    BENCHMARK("factorial(25)") {
-        return factorial(25);
+    BENCHMARK( "factorial_limbs(10000)" ) {
+        return factorial_limbs( static_cast<std::uint32_t>( opaque(10000) ) ).size();
+    };
+}
+
+TEST_CASE( "benchmarking the big factorial of a million", "[.][benchmark][large]" ) {
+    report_big_factorials( { 1000000 } );
+}
+
+namespace {
+    long double reference_log_factorial( std::uint64_t number ) {
+        return std::lgammal( static_cast<long double>( number ) + 1.0L );
+    }
+
+    std::vector<simd_backend> supported_backends() {
+        std::vector<simd_backend> backends;
+        for ( simd_backend backend : { simd_backend::scalar, simd_backend::avx2, simd_backend::avx512 } ) {
+            if ( simd_backend_supported( backend ) ) backends.push_back( backend );
+        }
+        return backends;
+    }
+
+    // Every n below 10^5, then a spread of larger values up to 2^50.
+    std::vector<std::uint64_t> log_factorial_inputs() {
+        std::vector<std::uint64_t> numbers( 100000 );
+        std::iota( numbers.begin(), numbers.end(), std::uint64_t{0} );
+        std::mt19937_64 rng( 3 );
+        for ( int i = 0; i < 100000; ++i ) {
+            numbers.push_back( rng() >> ( 14 + rng() % 40 ) );
+        }
+        return numbers;
+    }
+}
+
+TEST_CASE( "log_factorial matches long double lgamma" ) {
+    const std::vector<std::uint64_t> numbers = log_factorial_inputs();
+    double worst_scalar = 0.0;
+    double worst_batch = 0.0;
+    for ( simd_backend backend : supported_backends() ) {
+        std::vector<double> batch( numbers.size() );
+        log_factorial( numbers, batch, backend );
+        for ( std::size_t i = 0; i < numbers.size(); ++i ) {
+            const long double expected = reference_log_factorial( numbers[i] );
+            const double scale = std::max( 1.0, static_cast<double>( std::fabs( expected ) ) );
+            worst_scalar = std::max( worst_scalar, static_cast<double>( std::fabs( log_factorial( numbers[i] ) - expected ) ) / scale );
+            worst_batch = std::max( worst_batch, static_cast<double>( std::fabs( batch[i] - expected ) ) / scale );
+        }
+
+        std::vector<double> scalar_backend( numbers.size() );
+        log_factorial( numbers, scalar_backend, simd_backend::scalar );
+        REQUIRE( batch == scalar_backend );
+    }
+    std::cout << "log_factorial worst relative error: scalar " << worst_scalar << ", batch " << worst_batch << "\n";
+    REQUIRE( worst_scalar < 1e-15 );
+    REQUIRE( worst_batch < 1e-15 );
+
+    for ( std::uint64_t number = 0; number < factorial_detail::log_factorial_table_size; ++number ) {
+        REQUIRE( log_factorial( number ) == static_cast<double>( reference_log_factorial( number ) ) );
+    }
+}
+
+TEST_CASE( "log_choose matches long double lgamma" ) {
+    std::mt19937_64 rng( 4 );
+    std::vector<std::uint64_t> n, k;
+    for ( int i = 0; i < 100000; ++i ) {
+        n.push_back( rng() >> ( 20 + rng() % 44 ) );
+        k.push_back( n.back() == 0 ? 0 : rng() % ( n.back() + 1 ) );
+    }
+    for ( simd_backend backend : supported_backends() ) {
+        std::vector<double> batch( n.size() );
+        log_choose( n, k, batch, backend );
+        for ( std::size_t i = 0; i < n.size(); ++i ) {
+            const long double expected = reference_log_factorial( n[i] ) - reference_log_factorial( k[i] )
+                - reference_log_factorial( n[i] - k[i] );
+            // Absolute error of a few ulp of ln(n!).
+            const double tolerance = 8e-16 * std::max( 1.0, static_cast<double>( reference_log_factorial( n[i] ) ) );
+            REQUIRE( std::fabs( batch[i] - expected ) < tolerance );
+            REQUIRE( std::fabs( log_choose( n[i], k[i] ) - expected ) < tolerance );
+        }
+    }
+    REQUIRE( std::fabs( std::exp( log_choose( 52, 5 ) ) - 2598960.0 ) < 1e-6 );
+}
+
+TEST_CASE( "benchmarking log_factorial", "[benchmark]" ) {
+    std::mt19937_64 rng( 5 );
+    std::vector<std::uint64_t> numbers( 1 << 16 );
+    for ( std::uint64_t& number : numbers ) {
+        // Half from the table, half from Stirling: shoe-sized counts.
+        number = rng() % 2 ? rng() % 256 : 256 + rng() % 100000;
+    }
+    std::vector<double> out( numbers.size() );
+    const int repetitions = 200;
+
+    auto ns_per_value = [&]( auto run ) {
+        run();
+        auto start = std::chrono::high_resolution_clock::now();
+        for ( int rep = 0; rep < repetitions; ++rep ) {
+            run();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::nano>( end - start ).count()
+            / ( static_cast<double>( numbers.size() ) * repetitions );
     };
 
-    BENCHMARK("factorial(30)") {
-        return factorial(30);
+    std::cout << "\n";
+    const double lgamma = ns_per_value( [&] {
+        for ( std::size_t i = 0; i < numbers.size(); ++i ) {
+            out[i] = std::lgamma( static_cast<double>( numbers[i] ) + 1.0 );
+        }
+    } );
+    const double scalar = ns_per_value( [&] {
+        for ( std::size_t i = 0; i < numbers.size(); ++i ) {
+            out[i] = log_factorial( numbers[i] );
+        }
+    } );
+    std::cout << "std::lgamma: " << lgamma << " ns/value, log_factorial: " << scalar << " ns/value\n";
+    for ( simd_backend backend : supported_backends() ) {
+        const double batch = ns_per_value( [&] { log_factorial( numbers, out, backend ); } );
+        std::cout << "Batch log_factorial (" << simd_backend_name( backend ) << "): " << batch << " ns/value\n";
+    }
+
+    BENCHMARK( "log_factorial batch of 65536" ) {
+        log_factorial( numbers, out );
+        return out[0];
     };
 
-    BENCHMARK("factorial(35)") {
-        return factorial(35);
+    BENCHMARK( "log_choose batch of 65536" ) {
+        log_choose( numbers, numbers, out );
+        return out[0];
     };
 }
@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include "../src/feistel_permutation.hpp"
+
+TEST_CASE("Feistel Permutation - Correctness Tests", "[feistel]") {
+    SECTION("Every domain size gives a bijection") {
+        // Sizes just above and below powers of four stress the cycle walk.
+        for (std::uint64_t size : {1, 2, 3, 4, 5, 17, 52, 64, 65, 416, 1000, 4097, 65537, 1000003}) {
+            feistel_permutation permutation(size, size);
+            std::vector<bool> seen(size, false);
+            for (std::uint64_t i = 0; i < size; ++i) {
+                const std::uint64_t value = permutation(i);
+                REQUIRE(value < size);
+                REQUIRE_FALSE(seen[value]);
+                seen[value] = true;
+                REQUIRE(permutation.inverse(value) == i);
+            }
+        }
+    }
+
+    SECTION("Inverse round-trips on huge domains") {
+        for (std::uint64_t size : {std::uint64_t{10000000000}, (std::uint64_t{1} << 63) + 12345, UINT64_MAX}) {
+            feistel_permutation permutation(size, 7);
+            default_engine rng(size);
+            for (int trial = 0; trial < 10000; ++trial) {
+                const std::uint64_t index = bounded_random(rng, size);
+                const std::uint64_t value = permutation(index);
+                REQUIRE(value < size);
+                REQUIRE(permutation.inverse(value) == index);
+            }
+        }
+    }
+
+    SECTION("Different seeds give different orders") {
+        feistel_permutation first(1000, 1);
+        feistel_permutation second(1000, 2);
+        feistel_permutation from_engine(1000, default_engine(1));
+        int differences = 0;
+        int moved = 0;
+        for (std::uint64_t i = 0; i < 1000; ++i) {
+            differences += first(i) != second(i);
+            moved += from_engine(i) != i;
+        }
+        REQUIRE(differences > 900);
+        REQUIRE(moved > 900);
+    }
+
+    SECTION("Consecutive positions are not correlated") {
+        // Cells of the (pi(i), pi(i + 1)) pair over an 8x8 grid of the domain.
+        const std::uint64_t size = 1 << 20;
+        feistel_permutation permutation(size, 3);
+        std::vector<int> counts(64, 0);
+        std::uint64_t previous = permutation(0);
+        for (std::uint64_t i = 1; i < size; ++i) {
+            const std::uint64_t value = permutation(i);
+            counts[(previous * 8 / size) * 8 + value * 8 / size]++;
+            previous = value;
+        }
+        const double expected = (size - 1) / 64.0;
+        double chi_squared = 0.0;
+        for (int count : counts) {
+            const double diff = count - expected;
+            chi_squared += diff * diff / expected;
+        }
+        REQUIRE(chi_squared < 63 * 2.0);
+    }
+}
+
+TEST_CASE("Feistel Permutation - Lookup Throughput", "[feistel][benchmark]") {
+    const int lookups = 10000000;
+    for (std::uint64_t size : {std::uint64_t{52}, std::uint64_t{1000000}, std::uint64_t{10000000000},
+                               (std::uint64_t{1} << 40) + 1}) {
+        feistel_permutation permutation(size, 1);
+        auto lookups_per_second = [&](auto lookup) {
+            std::uint64_t sum = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < lookups; ++i) {
+                sum += lookup(static_cast<std::uint64_t>(i) % size);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            const double seconds = std::chrono::duration<double>(end - start).count();
+            REQUIRE(sum != 1);
+            return lookups / seconds;
+        };
+        const double forward = lookups_per_second([&](std::uint64_t i) { return permutation(i); });
+        const double inverse = lookups_per_second([&](std::uint64_t i) { return permutation.inverse(i); });
+        std::cout << "\nDomain Size: " << size << "\n";
+        std::cout << "Forward: " << forward / 1e6 << " M lookups/s\n";
+        std::cout << "Inverse: " << inverse / 1e6 << " M lookups/s\n";
+    }
+
+    feistel_permutation permutation(10000000000, 1);
+    std::uint64_t index = 0;
+    BENCHMARK("Forward lookup (size=10^10)") {
+        return permutation(index++ % permutation.size());
+    };
+    BENCHMARK("Inverse lookup (size=10^10)") {
+        return permutation.inverse(index++ % permutation.size());
+    };
+}
@@ -0,0 +1,188 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <unordered_set>
+#include "../src/multiset_sampler.hpp"
+#include "../src/shuffle.hpp"
+
+namespace {
+    // An eight-deck shoe by rank: 32 of each non-ten, 128 ten-valued cards.
+    std::vector<std::uint64_t> blackjack_shoe() {
+        std::vector<std::uint64_t> counts(10, 32);
+        counts[8] = 128;
+        return counts;
+    }
+}
+
+TEST_CASE("Multiset Sampler - Correctness Tests", "[multiset]") {
+    SECTION("Drawing everything returns each item count times") {
+        // Sizes below, at and above a node, and across several levels.
+        for (std::size_t size : {1, 7, 8, 9, 64, 65, 1000}) {
+            std::vector<std::uint64_t> counts(size);
+            for (std::size_t i = 0; i < size; ++i) {
+                counts[i] = i % 5;
+            }
+            counts[0] = 3;
+            multiset_sampler sampler(counts);
+            REQUIRE(sampler.size() == size);
+            REQUIRE(sampler.total() == std::accumulate(counts.begin(), counts.end(), std::uint64_t{0}));
+
+            default_engine rng(size);
+            std::vector<std::uint64_t> drawn(size, 0);
+            while (!sampler.empty()) {
+                drawn[sampler.draw(rng)]++;
+            }
+            REQUIRE(drawn == counts);
+        }
+    }
+
+    SECTION("add and count stay consistent with draws") {
+        multiset_sampler sampler(blackjack_shoe());
+        sampler.add(0, -32);
+        sampler.add(9, 10);
+        REQUIRE(sampler.count(0) == 0);
+        REQUIRE(sampler.count(9) == 42);
+        REQUIRE(sampler.total() == 416 - 32 + 10);
+        default_engine rng(1);
+        for (int i = 0; i < 300; ++i) {
+            const std::size_t item = sampler.draw(rng);
+            REQUIRE(item != 0);
+            REQUIRE(item < 10);
+        }
+        REQUIRE(sampler.total() == 94);
+    }
+
+    SECTION("Draws follow the counts") {
+        multiset_sampler sampler(blackjack_shoe());
+        default_engine rng(2);
+        const int trials = 416000;
+        std::vector<int> hits(10, 0);
+        for (int trial = 0; trial < trials; ++trial) {
+            hits[sampler.sample(rng)]++;
+        }
+        REQUIRE(sampler.total() == 416);
+        double chi_squared = 0.0;
+        const auto counts = blackjack_shoe();
+        for (std::size_t i = 0; i < 10; ++i) {
+            const double expected = trials * static_cast<double>(counts[i]) / 416.0;
+            const double diff = hits[i] - expected;
+            chi_squared += diff * diff / expected;
+        }
+        REQUIRE(chi_squared < 9 * 3.0);
+    }
+
+    SECTION("The k-th draw without replacement follows the counts") {
+        default_engine rng(3);
+        const int trials = 20000;
+        std::vector<int> hits(10, 0);
+        for (int trial = 0; trial < trials; ++trial) {
+            multiset_sampler sampler(blackjack_shoe());
+            for (int i = 0; i < 100; ++i) {
+                sampler.draw(rng);
+            }
+            hits[sampler.draw(rng)]++;
+        }
+        double chi_squared = 0.0;
+        const auto counts = blackjack_shoe();
+        for (std::size_t i = 0; i < 10; ++i) {
+            const double expected = trials * static_cast<double>(counts[i]) / 416.0;
+            const double diff = hits[i] - expected;
+            chi_squared += diff * diff / expected;
+        }
+        REQUIRE(chi_squared < 9 * 3.0);
+    }
+}
+
+namespace {
+    // Draws one copy in draw_fraction of a multiset with size items of 1-8
+    // copies each: through the sampler, by rejecting repeats of uniform copy
+    // indices with a hash set (what shuffle_random_sort used to do), and by
+    // pre-shuffling the expanded copies.
+    void report_ns_per_draw(std::size_t size, std::size_t draw_fraction) {
+        default_engine rng(1);
+        std::vector<std::uint64_t> counts(size);
+        for (auto& count : counts) {
+            count = 1 + bounded_random(rng, 8);
+        }
+        std::vector<std::uint32_t> copies;
+        for (std::size_t i = 0; i < size; ++i) {
+            copies.insert(copies.end(), counts[i], static_cast<std::uint32_t>(i));
+        }
+        const std::size_t total = copies.size();
+        const std::size_t draws = total / draw_fraction;
+
+        // Best of three runs; the first also warms up the allocator.
+        auto ns_per_draw = [&](auto run) {
+            double best = 1e300;
+            for (int attempt = 0; attempt < 3; ++attempt) {
+                std::uint64_t sum = 0;
+                auto start = std::chrono::high_resolution_clock::now();
+                run(sum);
+                auto end = std::chrono::high_resolution_clock::now();
+                REQUIRE(sum != 1);
+                best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count());
+            }
+            return best / static_cast<double>(draws);
+        };
+
+        const double build = ns_per_draw([&](std::uint64_t& sum) {
+            multiset_sampler sampler(counts);
+            sum += sampler.total();
+        });
+        const double sampler_draws = ns_per_draw([&](std::uint64_t& sum) {
+            multiset_sampler sampler(counts);
+            for (std::size_t i = 0; i < draws; ++i) {
+                sum += sampler.draw(rng);
+            }
+        });
+        const double hash_set = ns_per_draw([&](std::uint64_t& sum) {
+            std::unordered_set<std::uint64_t> taken;
+            while (taken.size() < draws) {
+                const std::uint64_t index = bounded_random(rng, total);
+                if (taken.insert(index).second) {
+                    sum += copies[index];
+                }
+            }
+        });
+        const double pre_shuffled = ns_per_draw([&](std::uint64_t& sum) {
+            std::vector<std::uint32_t> shuffled = copies;
+            shuffle_fisher_yates(shuffled, rng);
+            for (std::size_t i = 0; i < draws; ++i) {
+                sum += shuffled[i];
+            }
+        });
+
+        std::cout << "\nItems: " << size << ", copies: " << total << ", draws: " << draws << "\n";
+        std::cout << "Sampler: " << sampler_draws << " ns/draw (build alone " << build << ")\n";
+        std::cout << "Hash-set rejection: " << hash_set << " ns/draw\n";
+        std::cout << "Fisher-Yates pre-shuffle: " << pre_shuffled << " ns/draw\n";
+    }
+}
+
+TEST_CASE("Multiset Sampler - Draw Benchmarks", "[multiset][benchmark]") {
+    for (std::size_t draw_fraction : {100, 10}) {
+        report_ns_per_draw(10000, draw_fraction);
+        report_ns_per_draw(1000000, draw_fraction);
+    }
+
+    multiset_sampler sampler(blackjack_shoe());
+    default_engine rng(1);
+    BENCHMARK("Deal 60 cards by rank from an eight-deck shoe") {
+        multiset_sampler shoe = sampler;
+        std::uint64_t sum = 0;
+        for (int i = 0; i < 60; ++i) {
+            sum += shoe.draw(rng);
+        }
+        return sum;
+    };
+}
+
+TEST_CASE("Multiset Sampler - Large Multisets", "[.][multiset][benchmark][large]") {
+    report_ns_per_draw(20000000, 100);
+    report_ns_per_draw(20000000, 10);
+}
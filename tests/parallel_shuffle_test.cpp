@@ -0,0 +1,135 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <map>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include "../src/parallel_shuffle.hpp"
+
+namespace {
+    std::vector<int> iota_vector(size_t size) {
+        std::vector<int> values(size);
+        std::iota(values.begin(), values.end(), 0);
+        return values;
+    }
+
+    bool is_identity_after_sort(std::vector<int> values) {
+        std::sort(values.begin(), values.end());
+        return values == iota_vector(values.size());
+    }
+}
+
+TEST_CASE("Parallel Shuffle - Random Merge", "[parallel_shuffle]") {
+    SECTION("Merging two shuffled halves gives every permutation equally often") {
+        const int TRIALS = 120000;
+        default_engine rng(5);
+
+        for (size_t split : {0, 1, 2, 4}) {
+            std::map<std::vector<int>, int> counts;
+            for (int trial = 0; trial < TRIALS; ++trial) {
+                std::vector<int> values = iota_vector(5);
+                std::span<int> all(values);
+                shuffle_fisher_yates(all.first(split), rng);
+                shuffle_fisher_yates(all.subspan(split), rng);
+                merge_shuffled(all, split, rng);
+                counts[values]++;
+            }
+
+            REQUIRE(counts.size() == 120);
+            double expected = TRIALS / 120.0;
+            double chi_squared = 0.0;
+            for (const auto& [permutation, count] : counts) {
+                double diff = count - expected;
+                chi_squared += (diff * diff) / expected;
+            }
+            REQUIRE(chi_squared < 119 * 2.0);
+        }
+    }
+}
+
+TEST_CASE("Parallel Shuffle - Correctness Tests", "[parallel_shuffle]") {
+    SECTION("Sizes around the block boundaries stay permutations") {
+        for (size_t size : {size_t{0}, size_t{1}, size_t{52}, size_t{3} << 16, (size_t{1} << 20) + 7}) {
+            std::vector<int> values = iota_vector(size);
+            shuffle_parallel(values, 4);
+            REQUIRE(is_identity_after_sort(values));
+            if (size > 52) {
+                REQUIRE(values != iota_vector(size));
+            }
+        }
+    }
+
+    SECTION("The result depends on the seed but not on the thread count") {
+        const size_t size = (size_t{1} << 20) + 12345;
+        std::vector<int> one_thread = iota_vector(size);
+        std::vector<int> four_threads = iota_vector(size);
+        std::vector<int> other_seed = iota_vector(size);
+
+        shuffle_parallel(one_thread, rng_stream_manager(11), 1);
+        shuffle_parallel(four_threads, rng_stream_manager(11), 4);
+        shuffle_parallel(other_seed, rng_stream_manager(12), 4);
+
+        REQUIRE(one_thread == four_threads);
+        REQUIRE(one_thread != other_seed);
+    }
+
+    SECTION("Elements cross block boundaries uniformly") {
+        // Two blocks of 2^16; element 0 starts in the first one.
+        const size_t size = size_t{1} << 17;
+        const int TRIALS = 400;
+        const int BUCKETS = 8;
+        std::vector<int> bucket_counts(BUCKETS, 0);
+        std::vector<int> values(size);
+
+        for (int trial = 0; trial < TRIALS; ++trial) {
+            std::iota(values.begin(), values.end(), 0);
+            shuffle_parallel(values, rng_stream_manager(trial), 2);
+            size_t position = std::find(values.begin(), values.end(), 0) - values.begin();
+            bucket_counts[position * BUCKETS / size]++;
+        }
+
+        double expected = static_cast<double>(TRIALS) / BUCKETS;
+        double chi_squared = 0.0;
+        for (int count : bucket_counts) {
+            double diff = count - expected;
+            chi_squared += (diff * diff) / expected;
+        }
+        REQUIRE(chi_squared < 24.3); // p = 0.001 for 7 degrees of freedom
+    }
+}
+
+namespace {
+    void benchmark_strong_scaling(size_t size) {
+        std::vector<int> values = iota_vector(size);
+        const size_t max_threads = default_thread_count();
+
+        std::vector<size_t> thread_counts;
+        for (size_t threads = 1; threads < max_threads; threads *= 2) {
+            thread_counts.push_back(threads);
+        }
+        thread_counts.push_back(max_threads);
+
+        const std::string suffix = " (size=" + std::to_string(size) + ")";
+        BENCHMARK("Fisher-Yates" + suffix) {
+            shuffle_fisher_yates(values);
+            return values[0];
+        };
+        for (size_t threads : thread_counts) {
+            BENCHMARK("Parallel merge shuffle, " + std::to_string(threads) + " threads" + suffix) {
+                shuffle_parallel(values, threads);
+                return values[0];
+            };
+        }
+    }
+}
+
+TEST_CASE("Parallel Shuffle - Strong Scaling Benchmarks", "[parallel_shuffle][benchmark]") {
+    benchmark_strong_scaling(10000000);
+}
+
+TEST_CASE("Parallel Shuffle - Strong Scaling Benchmarks at 10^8", "[.][parallel_shuffle][benchmark][large]") {
+    benchmark_strong_scaling(100000000);
+}
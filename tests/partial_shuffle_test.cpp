@@ -0,0 +1,182 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include "../src/partial_shuffle.hpp"
+
+namespace {
+    std::vector<int> iota_vector(size_t size) {
+        std::vector<int> values(size);
+        std::iota(values.begin(), values.end(), 0);
+        return values;
+    }
+
+    // Chi-squared of the ordered 3-card deals from a 7-card deck (210 cells).
+    template <typename Deal>
+    double chi_squared_over_deals_of_3(int trials, Deal deal) {
+        std::vector<int> counts(7 * 7 * 7, 0);
+        std::vector<int> deck = iota_vector(7);
+        for (int trial = 0; trial < trials; ++trial) {
+            std::vector<int> dealt = deal(deck);
+            counts[(dealt[0] * 7 + dealt[1]) * 7 + dealt[2]]++;
+        }
+        double expected = trials / 210.0;
+        double chi_squared = 0.0;
+        for (int a = 0; a < 7; ++a) {
+            for (int b = 0; b < 7; ++b) {
+                for (int c = 0; c < 7; ++c) {
+                    const int count = counts[(a * 7 + b) * 7 + c];
+                    if (a == b || b == c || a == c) {
+                        if (count != 0) return 1e9;
+                        continue;
+                    }
+                    double diff = count - expected;
+                    chi_squared += (diff * diff) / expected;
+                }
+            }
+        }
+        return chi_squared;
+    }
+}
+
+TEST_CASE("Partial Shuffle - Correctness Tests", "[partial]") {
+    SECTION("Only the first k positions are touched") {
+        std::vector<int> values = iota_vector(416);
+        std::span<int> dealt = shuffle_prefix(values, 60, default_engine(1));
+        REQUIRE(dealt.data() == values.data());
+        REQUIRE(dealt.size() == 60);
+        std::vector<int> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        REQUIRE(sorted == iota_vector(416));
+        REQUIRE(shuffle_prefix(values, 1000, default_engine(2)).size() == 416);
+    }
+
+    SECTION("Dealt prefix is uniform, even from a shuffled deck") {
+        default_engine rng(3);
+        double fresh = chi_squared_over_deals_of_3(63000, [&](const std::vector<int>& deck) {
+            std::vector<int> values = deck;
+            auto dealt = shuffle_prefix(values, 3, rng);
+            return std::vector<int>(dealt.begin(), dealt.end());
+        });
+        REQUIRE(fresh < 209 * 1.5);
+
+        // Continuing from the previous deal's order must not bias the next one.
+        std::vector<int> shoe = iota_vector(7);
+        double reused = chi_squared_over_deals_of_3(63000, [&](const std::vector<int>&) {
+            auto dealt = shuffle_prefix(shoe, 3, rng);
+            return std::vector<int>(dealt.begin(), dealt.end());
+        });
+        REQUIRE(reused < 209 * 1.5);
+    }
+
+    SECTION("Dealing the whole deck is a uniform shuffle") {
+        default_engine rng(4);
+        double chi_squared = chi_squared_over_deals_of_3(63000, [&](const std::vector<int>& deck) {
+            std::vector<int> values = deck;
+            shuffle_prefix(values, values.size(), rng);
+            return std::vector<int>(values.end() - 3, values.end());
+        });
+        REQUIRE(chi_squared < 209 * 1.5);
+    }
+
+    SECTION("Cursor deals the same cards as shuffle_prefix") {
+        // Sizes and depths cover every batch width and the end of the deck.
+        for (size_t size : {1, 2, 3, 4, 5, 7, 52, 416, 100000}) {
+            for (size_t depth : {size_t{1}, size_t{3}, size_t{20}, size / 2, size}) {
+                if (depth > size) continue;
+                std::vector<int> prefix = iota_vector(size);
+                std::vector<int> cursor_deck = iota_vector(size);
+                default_engine prefix_rng(size * 31 + depth);
+                default_engine cursor_rng(size * 31 + depth);
+                shuffle_prefix(prefix, depth, prefix_rng);
+
+                deal_cursor cursor(cursor_deck, cursor_rng);
+                std::vector<int> dealt;
+                for (size_t card = 0; card < depth; ++card) {
+                    dealt.push_back(cursor.deal());
+                }
+                REQUIRE(cursor.dealt() == depth);
+                REQUIRE(cursor.remaining() == size - depth);
+                REQUIRE(cursor.empty() == (depth == size));
+                REQUIRE(std::equal(dealt.begin(), dealt.end(), prefix.begin()));
+                REQUIRE(cursor_deck == prefix);
+            }
+        }
+    }
+
+    SECTION("Reshuffled cursor deals a fresh permutation") {
+        std::vector<int> shoe = iota_vector(416);
+        default_engine rng(5);
+        deal_cursor cursor(shoe, rng);
+        for (int round = 0; round < 3; ++round) {
+            while (cursor.dealt() < 300) {
+                cursor.deal();
+            }
+            REQUIRE(cursor.dealt_cards().size() == 300);
+            cursor.reshuffle();
+            REQUIRE(cursor.dealt() == 0);
+        }
+        while (!cursor.empty()) {
+            cursor.deal();
+        }
+        std::vector<int> sorted = shoe;
+        std::sort(sorted.begin(), sorted.end());
+        REQUIRE(sorted == iota_vector(416));
+    }
+}
+
+TEST_CASE("Partial Shuffle - Blackjack Penetration", "[partial][benchmark]") {
+    // An eight-deck shoe dealt to typical cut-card depths, from a short
+    // round to 75% penetration.
+    const size_t shoe_size = 416;
+    default_engine rng(1);
+    std::vector<std::uint16_t> shoe(shoe_size);
+    std::iota(shoe.begin(), shoe.end(), std::uint16_t{0});
+    const int repetitions = 200000;
+
+    auto ns_per_shoe = [&](auto deal) {
+        deal();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int rep = 0; rep < repetitions; ++rep) {
+            deal();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / repetitions;
+    };
+
+    const double full = ns_per_shoe([&] { shuffle_fisher_yates(shoe, rng); });
+    std::cout << "\nFull Fisher-Yates (" << shoe_size << " cards): " << full << " ns/shoe\n";
+    for (size_t depth : {20, 40, 60, 104, 208, 312}) {
+        const double prefix = ns_per_shoe([&] { shuffle_prefix(shoe, depth, rng); });
+        const double cursor = ns_per_shoe([&] {
+            deal_cursor deal(shoe, rng);
+            std::uint32_t sum = 0;
+            for (size_t card = 0; card < depth; ++card) {
+                sum += deal.deal();
+            }
+            return sum;
+        });
+        std::cout << "Depth " << depth << ": shuffle_prefix " << prefix << " ns, deal_cursor " << cursor
+                  << " ns, speedup over full shuffle " << full / prefix << "x\n";
+    }
+
+    BENCHMARK("Full Fisher-Yates (416 cards)") {
+        shuffle_fisher_yates(shoe, rng);
+        return shoe[0];
+    };
+    BENCHMARK("shuffle_prefix (60 of 416 cards)") {
+        return shuffle_prefix(shoe, 60, rng)[0];
+    };
+    BENCHMARK("deal_cursor (60 of 416 cards)") {
+        deal_cursor deal(shoe, rng);
+        std::uint32_t sum = 0;
+        for (int card = 0; card < 60; ++card) {
+            sum += deal.deal();
+        }
+        return sum;
+    };
+}
@@ -0,0 +1,231 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <map>
+#include <string>
+#include <cstdint>
+#include <iostream>
+#include "../src/permutation_rank.hpp"
+
+namespace {
+    std::vector<std::uint8_t> iota_perm(size_t size) {
+        std::vector<std::uint8_t> values(size);
+        std::iota(values.begin(), values.end(), 0);
+        return values;
+    }
+
+    std::vector<std::uint8_t> unranked(const uint256& rank, size_t size, bit_select select) {
+        std::vector<std::uint8_t> perm(size);
+        permutation_unrank(rank, perm, select);
+        return perm;
+    }
+
+    std::vector<bit_select> supported_selects() {
+        std::vector<bit_select> selects;
+        for (bit_select select : {bit_select::portable, bit_select::bmi2}) {
+            if (bit_select_supported(select)) selects.push_back(select);
+        }
+        return selects;
+    }
+}
+
+TEST_CASE("Permutation Rank - Correctness Tests", "[permutation_rank]") {
+    SECTION("256-bit factorials") {
+        REQUIRE(to_string(*factorial_u256(0)) == "1");
+        REQUIRE(to_string(*factorial_u256(52))
+                == "80658175170943878571660636856403766975289505440883277824000000000000");
+        REQUIRE(to_string(*factorial_u256(57))
+                == "40526919504877216755680601905432322134980384796226602145184481280000000000000");
+        for (int n = 0; n <= static_cast<int>(factorial_u128_max); ++n) {
+            const unsigned __int128 small = *factorial_u128(n);
+            const uint256 wide = *factorial_u256(n);
+            REQUIRE(wide.words[0] == static_cast<std::uint64_t>(small));
+            REQUIRE(wide.words[1] == static_cast<std::uint64_t>(small >> 64));
+            REQUIRE(wide.words[2] == 0);
+        }
+        REQUIRE(factorial_u256(58).error() == factorial_error::overflow);
+        REQUIRE(factorial_u256(-1).error() == factorial_error::negative);
+        REQUIRE(to_string(uint256{}) == "0");
+        REQUIRE(to_string(uint256{10000000000000000000u}) == "10000000000000000000");
+    }
+
+    SECTION("Ranks count permutations in lexicographic order") {
+        for (bit_select select : supported_selects()) {
+            for (size_t size : {0, 1, 2, 3, 6}) {
+                std::vector<std::uint8_t> perm = iota_perm(size);
+                std::uint64_t expected = 0;
+                do {
+                    REQUIRE(permutation_rank(perm, select) == uint256{expected});
+                    REQUIRE(unranked(expected, size, select) == perm);
+                    ++expected;
+                } while (std::next_permutation(perm.begin(), perm.end()));
+                REQUIRE(uint256{expected} == *factorial_u256(static_cast<int>(size)));
+            }
+        }
+    }
+
+    SECTION("Identity, reversal and random permutations of every size round trip") {
+        default_engine rng(3);
+        for (bit_select select : supported_selects()) {
+            for (size_t size = 1; size <= permutation_rank_max_size; ++size) {
+                std::vector<std::uint8_t> perm = iota_perm(size);
+                REQUIRE(permutation_rank(perm, select) == uint256{});
+
+                std::reverse(perm.begin(), perm.end());
+                uint256 last = *factorial_u256(static_cast<int>(size));
+                for (size_t w = 0; w < 4 && last.words[w]-- == 0; ++w) {}
+                REQUIRE(permutation_rank(perm, select) == last);
+                REQUIRE(unranked(last, size, select) == perm);
+
+                for (int trial = 0; trial < 50; ++trial) {
+                    shuffle_fisher_yates(std::span(perm), rng);
+                    const uint256 rank = permutation_rank(perm, select);
+                    REQUIRE(rank < *factorial_u256(static_cast<int>(size)));
+                    REQUIRE(unranked(rank, size, select) == perm);
+                }
+            }
+        }
+    }
+
+    SECTION("Ranks order permutations as lexicographic comparison does") {
+        default_engine rng(4);
+        std::vector<std::uint8_t> a = iota_perm(52);
+        std::vector<std::uint8_t> b = iota_perm(52);
+        for (int trial = 0; trial < 1000; ++trial) {
+            shuffle_fisher_yates(std::span(a), rng);
+            // Mostly equal prefixes, so the comparison is decided late.
+            b = a;
+            std::next_permutation(b.begin() + static_cast<long>(trial % 50), b.end());
+            REQUIRE((permutation_rank(a) < permutation_rank(b)) == (a < b));
+        }
+    }
+
+    SECTION("shuffle_by_unrank rearranges any element type") {
+        std::vector<std::string> names = {"ann", "bo", "cy", "di", "ed", "flo", "gus"};
+        std::vector<std::string> sorted = names;
+        shuffle_by_unrank(names, default_engine(5));
+        std::vector<std::string> restored = names;
+        std::sort(restored.begin(), restored.end());
+        REQUIRE(restored == sorted);
+
+        std::vector<int> empty;
+        shuffle_by_unrank(empty);
+        std::vector<int> one = {7};
+        shuffle_by_unrank(one);
+        REQUIRE(one == std::vector<int>{7});
+    }
+}
+
+TEST_CASE("Permutation Rank - Statistical Validation", "[permutation_rank][randomness]") {
+    default_engine rng(6);
+
+    SECTION("All 120 orders of 5 elements are equally likely") {
+        std::map<std::uint64_t, int> counts;
+        const int trials = 120000;
+        for (int trial = 0; trial < trials; ++trial) {
+            std::vector<std::uint8_t> values = iota_perm(5);
+            shuffle_by_unrank(values, rng);
+            counts[permutation_rank(values).words[0]]++;
+        }
+        REQUIRE(counts.size() == 120);
+        const double expected = trials / 120.0;
+        double chi_squared = 0.0;
+        for (const auto& [outcome, count] : counts) {
+            const double diff = count - expected;
+            chi_squared += diff * diff / expected;
+        }
+        REQUIRE(chi_squared < 119 * 1.5);
+    }
+
+    SECTION("Each card lands in each position of a 52-card deck equally often") {
+        std::vector<std::vector<int>> counts(52, std::vector<int>(52, 0));
+        const int trials = 52000;
+        for (int trial = 0; trial < trials; ++trial) {
+            std::vector<std::uint8_t> deck = iota_perm(52);
+            shuffle_by_unrank(deck, rng);
+            for (size_t position = 0; position < 52; ++position) {
+                counts[position][deck[position]]++;
+            }
+        }
+        const double expected = trials / 52.0;
+        double chi_squared = 0.0;
+        for (const auto& row : counts) {
+            for (int count : row) {
+                const double diff = count - expected;
+                chi_squared += diff * diff / expected;
+            }
+        }
+        // 51 * 51 degrees of freedom.
+        REQUIRE(chi_squared < 2601 * 1.2);
+    }
+}
+
+TEST_CASE("Permutation Rank - 52-Card Decks", "[permutation_rank][benchmark]") {
+    default_engine rng(1);
+    const int decks = 4096;
+    std::vector<std::vector<std::uint8_t>> dealt(decks, iota_perm(52));
+    for (auto& deck : dealt) {
+        shuffle_fisher_yates(std::span(deck), rng);
+    }
+    std::vector<uint256> ranks(decks);
+    const int repetitions = 50;
+
+    auto ns_per_deck = [&](auto run) {
+        run();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int rep = 0; rep < repetitions; ++rep) {
+            run();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(decks) * repetitions);
+    };
+
+    std::cout << "\nDecks: 52 cards\n";
+    for (bit_select select : supported_selects()) {
+        const double rank = ns_per_deck([&] {
+            for (int d = 0; d < decks; ++d) {
+                ranks[d] = permutation_rank(dealt[d], select);
+            }
+        });
+        std::vector<std::uint8_t> deck(52);
+        const double unrank = ns_per_deck([&] {
+            for (int d = 0; d < decks; ++d) {
+                permutation_unrank(ranks[d], deck, select);
+            }
+        });
+        std::cout << bit_select_name(select) << ": rank " << rank << " ns/deck, unrank " << unrank << " ns/deck\n";
+    }
+
+    std::vector<std::uint8_t> deck = iota_perm(52);
+    const double fisher_yates = ns_per_deck([&] {
+        for (int d = 0; d < decks; ++d) {
+            shuffle_fisher_yates(std::span(deck), rng);
+        }
+    });
+    const double by_unrank = ns_per_deck([&] {
+        for (int d = 0; d < decks; ++d) {
+            shuffle_by_unrank(deck, rng);
+        }
+    });
+    std::cout << "Fisher-Yates: " << fisher_yates << " ns/deck, shuffle_by_unrank: " << by_unrank << " ns/deck\n";
+
+    BENCHMARK("permutation_rank (52 cards)") {
+        return permutation_rank(deck);
+    };
+    const uint256 rank = permutation_rank(deck);
+    BENCHMARK("permutation_unrank (52 cards)") {
+        permutation_unrank(rank, deck);
+        return deck[0];
+    };
+    BENCHMARK("shuffle_fisher_yates (52 cards)") {
+        shuffle_fisher_yates(std::span(deck), rng);
+        return deck[0];
+    };
+    BENCHMARK("shuffle_by_unrank (52 cards)") {
+        shuffle_by_unrank(deck, rng);
+        return deck[0];
+    };
+}
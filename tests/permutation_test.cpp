@@ -0,0 +1,180 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <cstdint>
+#include <iostream>
+#include "../src/permutation.hpp"
+
+namespace {
+    std::vector<std::uint64_t> iota_column(size_t size, std::uint64_t offset = 0) {
+        std::vector<std::uint64_t> values(size);
+        std::iota(values.begin(), values.end(), offset);
+        return values;
+    }
+
+    template <typename T>
+    std::vector<T> gathered(const permutation& p, const std::vector<T>& column) {
+        std::vector<T> out(column.size());
+        p.apply(std::span<const T>(column), std::span<T>(out));
+        return out;
+    }
+}
+
+TEST_CASE("Permutation - Correctness Tests", "[permutation]") {
+    // 300000 8-byte elements take the two-pass path, the rest gather
+    // directly.
+    const std::vector<size_t> sizes = {0, 1, 2, 7, 1000, 100000, 300000};
+
+    SECTION("Applying matches the index definition, in place or not") {
+        for (size_t size : sizes) {
+            const permutation p(size, default_engine(size));
+            const std::vector<std::uint64_t> column = iota_column(size, 5);
+
+            std::vector<std::uint64_t> expected(size);
+            for (size_t i = 0; i < size; ++i) {
+                expected[i] = column[p[i]];
+            }
+            REQUIRE(gathered(p, column) == expected);
+            std::vector<std::uint64_t> in_place = column;
+            p.apply(in_place);
+            REQUIRE(in_place == expected);
+
+            std::vector<std::uint64_t> restored(size);
+            p.apply_inverse(std::span<const std::uint64_t>(expected), std::span(restored));
+            REQUIRE(restored == column);
+            p.apply_inverse(in_place);
+            REQUIRE(in_place == column);
+
+            std::vector<std::uint64_t> by_cycles = column;
+            p.apply_by_cycles(by_cycles);
+            REQUIRE(by_cycles == expected);
+            p.apply_inverse_by_cycles(by_cycles);
+            REQUIRE(by_cycles == column);
+        }
+    }
+
+    SECTION("Matches shuffling each column with a reseeded engine") {
+        for (size_t size : sizes) {
+            const permutation p(size, default_engine(42));
+            std::vector<std::uint64_t> column = iota_column(size, 1000);
+            std::vector<std::uint64_t> applied = gathered(p, column);
+            shuffle_fisher_yates(std::span(column), default_engine(42));
+            REQUIRE(applied == column);
+        }
+    }
+
+    SECTION("Inverse and compose") {
+        for (size_t size : sizes) {
+            const permutation p(size, default_engine(1));
+            const permutation q(size, default_engine(2));
+            const std::vector<std::uint64_t> column = iota_column(size);
+
+            const permutation identity = p.compose(p.inverse());
+            REQUIRE(std::ranges::equal(identity.indices(), permutation(size).indices()));
+            REQUIRE(gathered(p.compose(q), column) == gathered(q, gathered(p, column)));
+        }
+    }
+
+    SECTION("Moves elements that are not trivially copyable") {
+        std::vector<std::string> names = {"ann", "bo", "cy", "di", "ed"};
+        const permutation p(std::vector<std::uint32_t>{2, 0, 1, 4, 3});
+        p.apply(names);
+        REQUIRE(names == std::vector<std::string>{"cy", "ann", "bo", "ed", "di"});
+        p.apply_inverse(names);
+        REQUIRE(names == std::vector<std::string>{"ann", "bo", "cy", "di", "ed"});
+        p.apply_by_cycles(names);
+        REQUIRE(names == std::vector<std::string>{"cy", "ann", "bo", "ed", "di"});
+        p.apply_inverse_by_cycles(names);
+        REQUIRE(names == std::vector<std::string>{"ann", "bo", "cy", "di", "ed"});
+    }
+
+    SECTION("Sizes beyond 32-bit positions are rejected before allocating") {
+        const size_t too_big = permutation_max_size + 1;
+        REQUIRE_THROWS_AS(permutation(too_big), std::length_error);
+        REQUIRE_THROWS_AS(permutation(too_big, default_engine(3)), std::length_error);
+    }
+}
+
+TEST_CASE("Permutation - Columns", "[permutation][benchmark]") {
+    const size_t column_count = 4;
+    for (size_t size : {100000, 1000000, 10000000}) {
+        std::vector<std::vector<std::uint64_t>> columns;
+        for (size_t column = 0; column < column_count; ++column) {
+            columns.push_back(iota_column(size, column * size));
+        }
+        std::vector<std::uint64_t> out(size);
+        const int repetitions = static_cast<int>(std::max<size_t>(1, 4000000 / size));
+
+        auto ns_per_element = [&](auto run) {
+            run();
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int rep = 0; rep < repetitions; ++rep) {
+                run();
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double, std::nano>(end - start).count()
+                / (static_cast<double>(size * column_count) * repetitions);
+        };
+
+        const double reseeded = ns_per_element([&] {
+            for (auto& column : columns) {
+                shuffle_fisher_yates(std::span(column), default_engine(7));
+            }
+        });
+        const permutation p(size, default_engine(7));
+        const double direct = ns_per_element([&] {
+            const std::uint32_t* indices = p.indices().data();
+            for (auto& column : columns) {
+                for (size_t i = 0; i < size; ++i) {
+                    out[i] = column[indices[i]];
+                }
+            }
+        });
+        const double blocked = ns_per_element([&] {
+            for (auto& column : columns) {
+                p.apply(std::span<const std::uint64_t>(column), std::span(out));
+            }
+        });
+        const double in_place = ns_per_element([&] {
+            for (auto& column : columns) {
+                p.apply(column);
+            }
+        });
+        const double by_cycles = ns_per_element([&] {
+            for (auto& column : columns) {
+                p.apply_by_cycles(column);
+            }
+        });
+        std::cout << "\nElements: " << size << " x " << column_count << " columns\n"
+                  << "Fisher-Yates per column, reseeded: " << reseeded << " ns/element\n"
+                  << "Direct gather: " << direct << " ns/element\n"
+                  << "permutation::apply, out of place: " << blocked << " ns/element\n"
+                  << "permutation::apply, in place: " << in_place << " ns/element\n"
+                  << "permutation::apply_by_cycles: " << by_cycles << " ns/element\n";
+    }
+
+    std::vector<std::uint64_t> column = iota_column(1000000);
+    std::vector<std::uint64_t> out(1000000);
+    const permutation p(1000000, default_engine(7));
+    BENCHMARK("Fisher-Yates, reseeded (size=1000000)") {
+        shuffle_fisher_yates(std::span(column), default_engine(7));
+        return column[0];
+    };
+    BENCHMARK("permutation::apply out of place (size=1000000)") {
+        p.apply(std::span<const std::uint64_t>(column), std::span(out));
+        return out[0];
+    };
+    BENCHMARK("permutation::apply in place (size=1000000)") {
+        p.apply(column);
+        return column[0];
+    };
+    BENCHMARK("permutation::apply_by_cycles (size=1000000)") {
+        p.apply_by_cycles(column);
+        return column[0];
+    };
+}
@@ -0,0 +1,96 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include "../src/shuffle.hpp"
+
+namespace {
+    std::vector<int> iota_vector(size_t size) {
+        std::vector<int> values(size);
+        std::iota(values.begin(), values.end(), 0);
+        return values;
+    }
+}
+
+TEST_CASE("Prefetched Fisher-Yates - Correctness Tests", "[prefetch]") {
+    SECTION("Output matches shuffle_fisher_yates for the same engine") {
+        // Sizes cover every batch width and the short tail schedules.
+        for (size_t size : {0, 1, 2, 3, 4, 5, 6, 7, 15, 16, 17, 20, 21, 52, 1000, 20000, 300000}) {
+            std::vector<int> prefetched = iota_vector(size);
+            std::vector<int> plain = iota_vector(size);
+            default_engine prefetched_rng(size);
+            default_engine plain_rng(size);
+            shuffle_fisher_yates_prefetched(prefetched, prefetched_rng);
+            shuffle_fisher_yates(plain, plain_rng);
+            REQUIRE(prefetched == plain);
+            REQUIRE(prefetched_rng == plain_rng);
+        }
+    }
+
+    SECTION("Matches for engines narrower than 64 bits") {
+        std::vector<int> prefetched = iota_vector(5000);
+        std::vector<int> plain = iota_vector(5000);
+        shuffle_fisher_yates_prefetched(prefetched, std::mt19937(11));
+        shuffle_fisher_yates(plain, std::mt19937(11));
+        REQUIRE(prefetched == plain);
+    }
+
+    SECTION("Result is a permutation") {
+        std::vector<int> values = iota_vector(100000);
+        shuffle_fisher_yates_prefetched(values);
+        std::sort(values.begin(), values.end());
+        REQUIRE(values == iota_vector(100000));
+    }
+}
+
+namespace {
+    void report_ns_per_element(const std::vector<size_t>& sizes) {
+        default_engine rng(1);
+        for (size_t size : sizes) {
+            std::vector<std::uint32_t> values(size);
+            std::iota(values.begin(), values.end(), 0u);
+            const int repetitions = static_cast<int>(std::max<size_t>(1, 20000000 / size));
+
+            auto ns_per_element = [&](auto shuffle_func) {
+                shuffle_func(values);
+                auto start = std::chrono::high_resolution_clock::now();
+                for (int rep = 0; rep < repetitions; ++rep) {
+                    shuffle_func(values);
+                }
+                auto end = std::chrono::high_resolution_clock::now();
+                return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(size) * repetitions);
+            };
+
+            double plain = ns_per_element([&](std::vector<std::uint32_t>& v) { shuffle_fisher_yates(v, rng); });
+            double prefetched = ns_per_element([&](std::vector<std::uint32_t>& v) { shuffle_fisher_yates_prefetched(v, rng); });
+
+            std::cout << "\nArray Size: " << size << " (" << size * sizeof(std::uint32_t) / 1024 << " KiB)\n";
+            std::cout << "Fisher-Yates: " << plain << " ns/element\n";
+            std::cout << "Prefetched: " << prefetched << " ns/element\n";
+            std::cout << "Speedup: " << plain / prefetched << "x\n";
+        }
+    }
+}
+
+TEST_CASE("Prefetched Fisher-Yates - Size Sweep", "[prefetch][benchmark]") {
+    // From L2-resident through last-level cache to DRAM-resident arrays.
+    report_ns_per_element({16384, 262144, 1048576, 4194304, 16777216, 67108864});
+
+    std::vector<int> values = iota_vector(16777216);
+    BENCHMARK("Fisher-Yates (size=16777216)") {
+        shuffle_fisher_yates(values);
+        return values[0];
+    };
+    BENCHMARK("Prefetched (size=16777216)") {
+        shuffle_fisher_yates_prefetched(values);
+        return values[0];
+    };
+}
+
+TEST_CASE("Prefetched Fisher-Yates - DRAM Sizes", "[.][prefetch][benchmark][large]") {
+    report_ns_per_element({268435456, 1073741824});
+}
@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+#include <random>
+#include <string>
+#include "../src/random_engines.hpp"
+#include "../src/shuffle.hpp"
+
+static_assert(std::uniform_random_bit_generator<splitmix64>);
+static_assert(std::uniform_random_bit_generator<xoshiro256ss>);
+static_assert(std::uniform_random_bit_generator<pcg64>);
+static_assert(std::uniform_random_bit_generator<wyrand>);
+static_assert(std::uniform_random_bit_generator<philox4x32>);
+
+TEST_CASE("Random Engines - Known Answer Tests", "[engines]") {
+    SECTION("SplitMix64") {
+        splitmix64 rng(0);
+        REQUIRE(rng() == 0xe220a8397b1dcdaf);
+        REQUIRE(rng() == 0x6e789e6aa1b965f4);
+        REQUIRE(rng() == 0x06c45d188009454f);
+    }
+
+    SECTION("xoshiro256** seeded through SplitMix64") {
+        xoshiro256ss rng(42);
+        REQUIRE(rng() == 0x15780b2e0c2ec716);
+        REQUIRE(rng() == 0x6104d9866d113a7e);
+        REQUIRE(rng() == 0xae17533239e499a1);
+    }
+
+    SECTION("xoshiro256** jump") {
+        // Reference value from applying the 2^128-th power of the state
+        // transition matrix.
+        xoshiro256ss rng(42);
+        rng.jump();
+        REQUIRE(rng() == 0x50086ef83cbf4f4a);
+    }
+
+    SECTION("PCG64 matches pcg-cpp pcg64(42, 54)") {
+        pcg64 rng(42, 54);
+        REQUIRE(rng() == 0x86b1da1d72062b68);
+        REQUIRE(rng() == 0x1304aa46c9853d39);
+        REQUIRE(rng() == 0xa3670e9e0dd50358);
+    }
+
+    SECTION("wyrand") {
+        wyrand rng(42);
+        REQUIRE(rng() == 0xae4a7cbfdda9b434);
+        REQUIRE(rng() == 0xe9cc09d33d38d9d2);
+    }
+
+    SECTION("Philox4x32-10 matches the Random123 vectors") {
+        REQUIRE(philox4x32::generate({0, 0, 0, 0}, {0, 0})
+                == philox4x32::counter_type{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+        REQUIRE(philox4x32::generate({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0})
+                == philox4x32::counter_type{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+
+        philox4x32 rng(0);
+        REQUIRE(rng() == 0xe169c58d6627e8d5);
+        REQUIRE(rng() == 0x9b00dbd8bc57ac4c);
+    }
+}
+
+TEST_CASE("Random Engines - Shuffles Accept Any Engine", "[engines][shuffle]") {
+    auto shuffled_with = [](auto rng) {
+        std::vector<int> deck(52);
+        std::iota(deck.begin(), deck.end(), 0);
+        shuffle_fisher_yates(deck, rng);
+        shuffle_naive_swap(std::span(deck), rng);
+        shuffle_random_sort(deck, rng);
+        return deck;
+    };
+
+    SECTION("Equal seeds give equal shuffles") {
+        REQUIRE(shuffled_with(xoshiro256ss(1)) == shuffled_with(xoshiro256ss(1)));
+        REQUIRE(shuffled_with(pcg64(1)) == shuffled_with(pcg64(1)));
+        REQUIRE(shuffled_with(splitmix64(1)) == shuffled_with(splitmix64(1)));
+        REQUIRE(shuffled_with(wyrand(1)) == shuffled_with(wyrand(1)));
+        REQUIRE(shuffled_with(philox4x32(1)) == shuffled_with(philox4x32(1)));
+        REQUIRE(shuffled_with(std::mt19937(1)) == shuffled_with(std::mt19937(1)));
+    }
+
+    SECTION("Different seeds give different shuffles") {
+        REQUIRE(shuffled_with(xoshiro256ss(1)) != shuffled_with(xoshiro256ss(2)));
+        REQUIRE(shuffled_with(pcg64(1)) != shuffled_with(pcg64(1, 1)));
+        REQUIRE(shuffled_with(philox4x32(1)) != shuffled_with(philox4x32(2)));
+    }
+
+    SECTION("Shuffles stay permutations") {
+        std::vector<int> deck = shuffled_with(wyrand(7));
+        std::sort(deck.begin(), deck.end());
+        for (int i = 0; i < 52; ++i) {
+            REQUIRE(deck[i] == i);
+        }
+    }
+}
+
+namespace {
+    template <typename Engine>
+    void benchmark_engine(const std::string& engine_name, const std::vector<size_t>& sizes) {
+        Engine rng(2024);
+
+        BENCHMARK(engine_name + " raw output x1000") {
+            std::uint64_t sum = 0;
+            for (int i = 0; i < 1000; ++i) {
+                sum += rng();
+            }
+            return sum;
+        };
+
+        for (size_t size : sizes) {
+            std::vector<int> test_data(size);
+            std::iota(test_data.begin(), test_data.end(), 0);
+            const std::string suffix = " (" + engine_name + ", size=" + std::to_string(size) + ")";
+
+            BENCHMARK("Random Sort" + suffix) {
+                std::vector<int> copy = test_data;
+                shuffle_random_sort(copy, rng);
+                return copy;
+            };
+
+            BENCHMARK("Naive Swap" + suffix) {
+                std::vector<int> copy = test_data;
+                shuffle_naive_swap(copy, rng);
+                return copy;
+            };
+
+            BENCHMARK("Fisher-Yates" + suffix) {
+                std::vector<int> copy = test_data;
+                shuffle_fisher_yates(copy, rng);
+                return copy;
+            };
+        }
+    }
+}
+
+TEST_CASE("Random Engines - Engine x Algorithm x Size Benchmarks", "[engines][benchmark]") {
+    const std::vector<size_t> test_sizes = {52, 1000, 100000};
+
+    SECTION("std::mt19937") { benchmark_engine<std::mt19937>("mt19937", test_sizes); }
+    SECTION("xoshiro256**") { benchmark_engine<xoshiro256ss>("xoshiro256**", test_sizes); }
+    SECTION("PCG64") { benchmark_engine<pcg64>("pcg64", test_sizes); }
+    SECTION("SplitMix64") { benchmark_engine<splitmix64>("splitmix64", test_sizes); }
+    SECTION("wyrand") { benchmark_engine<wyrand>("wyrand", test_sizes); }
+    SECTION("Philox4x32-10") { benchmark_engine<philox4x32>("philox4x32", test_sizes); }
+}
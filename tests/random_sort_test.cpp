@@ -0,0 +1,181 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <map>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include "../src/shuffle.hpp"
+
+namespace {
+    std::vector<int> iota_vector(size_t size) {
+        std::vector<int> values(size);
+        std::iota(values.begin(), values.end(), 0);
+        return values;
+    }
+
+    template <typename Shuffle>
+    double chi_squared_over_permutations_of_5(int trials, Shuffle shuffle) {
+        std::map<std::vector<int>, int> counts;
+        for (int trial = 0; trial < trials; ++trial) {
+            std::vector<int> values = iota_vector(5);
+            shuffle(values);
+            counts[values]++;
+        }
+        if (counts.size() != 120) return 1e9;
+        double expected = trials / 120.0;
+        double chi_squared = 0.0;
+        for (const auto& [permutation, count] : counts) {
+            double diff = count - expected;
+            chi_squared += (diff * diff) / expected;
+        }
+        return chi_squared;
+    }
+}
+
+TEST_CASE("Random Sort Shuffle - Correctness Tests", "[random_sort]") {
+    SECTION("Packed and indexed elements stay permutations") {
+        std::vector<int> values = iota_vector(300000);
+        shuffle_random_sort(values, rng_stream_manager(1));
+        REQUIRE(values != iota_vector(300000));
+        std::sort(values.begin(), values.end());
+        REQUIRE(values == iota_vector(300000));
+
+        std::vector<std::string> words;
+        for (int i = 0; i < 100000; ++i) {
+            words.push_back("card " + std::to_string(i));
+        }
+        std::vector<std::string> shuffled = words;
+        shuffle_random_sort(shuffled, rng_stream_manager(2));
+        REQUIRE(shuffled != words);
+        std::sort(shuffled.begin(), shuffled.end());
+        std::sort(words.begin(), words.end());
+        REQUIRE(shuffled == words);
+    }
+
+    SECTION("Result does not depend on the thread count") {
+        std::vector<int> expected = iota_vector(1 << 20);
+        shuffle_random_sort(expected, rng_stream_manager(3), 1);
+        for (size_t threads : {2, 3, 8}) {
+            std::vector<int> values = iota_vector(1 << 20);
+            shuffle_random_sort(values, rng_stream_manager(3), threads);
+            REQUIRE(values == expected);
+        }
+    }
+
+    SECTION("Same engine state gives the same shuffle") {
+        std::vector<int> first = iota_vector(1000);
+        std::vector<int> second = iota_vector(1000);
+        shuffle_random_sort(first, default_engine(4));
+        shuffle_random_sort(second, default_engine(4));
+        REQUIRE(first == second);
+    }
+
+    SECTION("Edge cases") {
+        std::vector<int> empty;
+        REQUIRE_NOTHROW(shuffle_random_sort(empty, rng_stream_manager(5)));
+        std::vector<int> single = {42};
+        shuffle_random_sort(single, rng_stream_manager(5));
+        REQUIRE(single == std::vector<int>{42});
+    }
+}
+
+TEST_CASE("Random Sort Shuffle - Randomness Quality Tests", "[random_sort][randomness]") {
+    default_engine seeds(6);
+
+    SECTION("Every permutation of 5 elements is equally likely") {
+        double chi_squared = chi_squared_over_permutations_of_5(60000, [&](std::vector<int>& values) {
+            shuffle_random_sort(values, seeds);
+        });
+        REQUIRE(chi_squared < 119 * 2.0);
+    }
+
+    SECTION("Key collisions are broken uniformly") {
+        // One key byte: two of five keys collide in about 4% of the shuffles.
+        double chi_squared = chi_squared_over_permutations_of_5(60000, [&](std::vector<int>& values) {
+            shuffle_detail::random_sort(std::span<int>(values), rng_stream_manager(seeds()), 1, 1);
+        });
+        REQUIRE(chi_squared < 119 * 2.0);
+    }
+
+    SECTION("Card positions are uniform with mostly colliding keys") {
+        // 300 elements over 256 key values: nearly every key is shared.
+        const int TRIALS = 2000;
+        const int ARRAY_SIZE = 300;
+        const int BUCKETS = 10;
+        std::vector<int> position_counts(ARRAY_SIZE * BUCKETS, 0);
+        for (int trial = 0; trial < TRIALS; ++trial) {
+            std::vector<int> values = iota_vector(ARRAY_SIZE);
+            shuffle_detail::random_sort(std::span<int>(values), rng_stream_manager(seeds()), 1, 1);
+            for (int pos = 0; pos < ARRAY_SIZE; ++pos) {
+                position_counts[values[pos] * BUCKETS + pos * BUCKETS / ARRAY_SIZE]++;
+            }
+        }
+
+        double expected = static_cast<double>(TRIALS) / BUCKETS;
+        double chi_squared = 0.0;
+        for (int count : position_counts) {
+            double diff = count - expected;
+            chi_squared += (diff * diff) / expected;
+        }
+        REQUIRE(chi_squared < (ARRAY_SIZE * (BUCKETS - 1)) * 1.2);
+    }
+}
+
+namespace {
+    void report_random_sort(const std::vector<size_t>& sizes) {
+        default_engine rng(1);
+        for (size_t size : sizes) {
+            std::vector<int> values = iota_vector(size);
+            const int repetitions = static_cast<int>(std::max<size_t>(1, 10000000 / size));
+
+            auto ns_per_element = [&](auto shuffle_func) {
+                shuffle_func(values);
+                auto start = std::chrono::high_resolution_clock::now();
+                for (int rep = 0; rep < repetitions; ++rep) {
+                    shuffle_func(values);
+                }
+                auto end = std::chrono::high_resolution_clock::now();
+                return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(size) * repetitions);
+            };
+
+            // Reference point for memory bandwidth: one copy of the 8-byte sort records.
+            std::vector<std::uint64_t> records(size, 1);
+            std::vector<std::uint64_t> copy(size);
+            const double copy_ns = ns_per_element([&](std::vector<int>&) {
+                std::memcpy(copy.data(), records.data(), size * sizeof(std::uint64_t));
+            });
+
+            std::cout << "\nArray Size: " << size << "\n";
+            std::cout << "Fisher-Yates: " << ns_per_element([&](std::vector<int>& v) { shuffle_fisher_yates(v, rng); }) << " ns/element\n";
+            for (size_t threads = 1; threads <= default_thread_count(); threads *= 2) {
+                const rng_stream_manager streams(rng());
+                double ns = ns_per_element([&](std::vector<int>& v) { shuffle_random_sort(v, streams, threads); });
+                std::cout << "Random sort, " << threads << " thread(s): " << ns << " ns/element, "
+                          << ns / copy_ns << "x the time of one copy of the records\n";
+            }
+        }
+    }
+}
+
+TEST_CASE("Random Sort Shuffle - Size Sweep", "[random_sort][benchmark]") {
+    report_random_sort({10000, 100000, 1000000, 10000000});
+
+    std::vector<int> values = iota_vector(1000000);
+    BENCHMARK("Fisher-Yates (size=1000000)") {
+        shuffle_fisher_yates(values);
+        return values[0];
+    };
+    BENCHMARK("Random sort (size=1000000)") {
+        shuffle_random_sort(values);
+        return values[0];
+    };
+}
+
+TEST_CASE("Random Sort Shuffle - 10^8 Elements", "[.][random_sort][benchmark][large]") {
+    report_random_sort({100000000});
+}
@@ -0,0 +1,199 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+#include <thread>
+#include "../src/parallel_for.hpp"
+#include "../src/rng_streams.hpp"
+#include "../src/shuffle.hpp"
+
+namespace {
+    // Every worker seeds its own stream, shuffles a shoe a number of times
+    // and records the final order of each shuffle.
+    std::vector<std::vector<int>> run_threads(std::uint64_t master_seed, size_t thread_count, int shuffles_per_thread) {
+        std::vector<std::vector<int>> results(thread_count);
+        std::vector<std::thread> workers;
+
+        for (size_t id = 0; id < thread_count; ++id) {
+            workers.emplace_back([&, id] {
+                seed_thread_rng(master_seed, id);
+                std::vector<int> shoe(416);
+                for (int round = 0; round < shuffles_per_thread; ++round) {
+                    std::iota(shoe.begin(), shoe.end(), 0);
+                    shuffle_fisher_yates(shoe);
+                    results[id].insert(results[id].end(), shoe.begin(), shoe.end());
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return results;
+    }
+}
+
+TEST_CASE("RNG Streams - Stream Derivation", "[rng_streams]") {
+    rng_stream_manager streams(2024);
+
+    SECTION("Stream k is the master engine jumped k times") {
+        default_engine expected(2024);
+        for (size_t k = 0; k < 5; ++k) {
+            REQUIRE(streams.stream(k) == expected);
+            expected.jump();
+        }
+    }
+
+    SECTION("streams() matches stream()") {
+        std::vector<default_engine> engines = streams.streams(16);
+        REQUIRE(engines.size() == 16);
+        for (size_t k = 0; k < engines.size(); ++k) {
+            REQUIRE(engines[k] == streams.stream(k));
+        }
+    }
+
+    SECTION("Streams and seeds produce different sequences") {
+        REQUIRE(streams.stream(0)() != streams.stream(1)());
+        REQUIRE(rng_stream_manager(1).stream(0)() != rng_stream_manager(2).stream(0)());
+    }
+}
+
+TEST_CASE("RNG Streams - Per-Thread Engines", "[rng_streams][threads]") {
+    SECTION("Seeding a thread's engine selects the stream") {
+        seed_thread_rng(99, 3);
+        REQUIRE(get_rng() == rng_stream_manager(99).stream(3));
+    }
+
+    SECTION("Threads own distinct engines") {
+        default_engine* main_engine = &get_rng();
+        default_engine* worker_engine = nullptr;
+        default_engine worker_state;
+        std::thread worker([&] {
+            worker_engine = &get_rng();
+            worker_state = get_rng();
+        });
+        worker.join();
+
+        REQUIRE(worker_engine != main_engine);
+        REQUIRE(worker_state != get_rng());
+    }
+
+    SECTION("A 64-thread run is bit-identical to a rerun") {
+        auto first = run_threads(42, 64, 20);
+        auto second = run_threads(42, 64, 20);
+        REQUIRE(first == second);
+        REQUIRE(first[0] != first[1]);
+        REQUIRE(run_threads(43, 64, 20) != first);
+    }
+
+    SECTION("Threaded results match a sequential replay of the same streams") {
+        auto threaded = run_threads(7, 8, 10);
+
+        rng_stream_manager streams(7);
+        for (size_t id = 0; id < threaded.size(); ++id) {
+            default_engine engine = streams.stream(id);
+            std::vector<int> replay;
+            std::vector<int> shoe(416);
+            for (int round = 0; round < 10; ++round) {
+                std::iota(shoe.begin(), shoe.end(), 0);
+                shuffle_fisher_yates(shoe, engine);
+                replay.insert(replay.end(), shoe.begin(), shoe.end());
+            }
+            REQUIRE(replay == threaded[id]);
+        }
+    }
+}
+
+namespace {
+    std::vector<int> deal_deck(std::uint64_t master_seed, std::uint32_t shoe, std::uint32_t deck) {
+        std::vector<int> cards(52);
+        std::iota(cards.begin(), cards.end(), 0);
+        shuffle_fisher_yates(cards, deck_engine(master_seed, shoe, deck));
+        return cards;
+    }
+}
+
+TEST_CASE("RNG Streams - Counter-Based Deck Engines", "[rng_streams][counter]") {
+    const std::uint32_t shoes = 64;
+    const std::uint32_t decks_per_shoe = 8;
+
+    SECTION("Parallel generation matches a sequential replay in any order") {
+        std::vector<std::vector<int>> parallel(shoes * decks_per_shoe);
+        parallel_for(parallel.size(), 8, [&](size_t i) {
+            parallel[i] = deal_deck(99, static_cast<std::uint32_t>(i / decks_per_shoe),
+                                    static_cast<std::uint32_t>(i % decks_per_shoe));
+        });
+        for (size_t i = parallel.size(); i-- > 0; ) {
+            REQUIRE(deal_deck(99, static_cast<std::uint32_t>(i / decks_per_shoe),
+                              static_cast<std::uint32_t>(i % decks_per_shoe)) == parallel[i]);
+        }
+    }
+
+    SECTION("Seed, shoe and deck all select the sequence") {
+        REQUIRE(deal_deck(1, 0, 0) != deal_deck(2, 0, 0));
+        REQUIRE(deal_deck(1, 0, 0) != deal_deck(1, 1, 0));
+        REQUIRE(deal_deck(1, 0, 0) != deal_deck(1, 0, 1));
+        REQUIRE(deal_deck(1, 1, 0) != deal_deck(1, 0, 1));
+    }
+
+    SECTION("discard skips outputs in constant time") {
+        for (unsigned long long skip : {0ull, 1ull, 2ull, 3ull, 1001ull}) {
+            for (int consumed : {0, 1, 2, 3}) {
+                philox4x32 stepped = deck_engine(5, 7, 3);
+                philox4x32 skipped = deck_engine(5, 7, 3);
+                for (int i = 0; i < consumed; ++i) {
+                    stepped();
+                    skipped();
+                }
+                for (unsigned long long i = 0; i < skip; ++i) {
+                    stepped();
+                }
+                skipped.discard(skip);
+                for (int i = 0; i < 5; ++i) {
+                    REQUIRE(skipped() == stepped());
+                }
+            }
+        }
+    }
+
+    SECTION("Stream 0 is the single-seed engine") {
+        philox4x32 seeded(42);
+        philox4x32 stream(42, 0);
+        for (int i = 0; i < 8; ++i) {
+            REQUIRE(seeded() == stream());
+        }
+    }
+}
+
+TEST_CASE("RNG Streams - Performance Benchmarks", "[rng_streams][benchmark]") {
+    rng_stream_manager streams(1);
+
+    BENCHMARK("stream(63)") {
+        return streams.stream(63);
+    };
+
+    BENCHMARK("streams(64)") {
+        return streams.streams(64);
+    };
+
+    std::vector<int> deck(52);
+    std::iota(deck.begin(), deck.end(), 0);
+
+    BENCHMARK("Fisher-Yates with the thread-local engine (size=52)") {
+        shuffle_fisher_yates(deck);
+        return deck[0];
+    };
+
+    default_engine local(1);
+    BENCHMARK("Fisher-Yates with a local engine (size=52)") {
+        shuffle_fisher_yates(deck, local);
+        return deck[0];
+    };
+
+    std::uint32_t deck_id = 0;
+    BENCHMARK("Fisher-Yates with a fresh deck_engine per deck (size=52)") {
+        shuffle_fisher_yates(deck, deck_engine(1, 1000000, deck_id++));
+        return deck[0];
+    };
+}
@@ -0,0 +1,158 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_set>
+#include "../src/sample.hpp"
+
+namespace {
+    using sampler = std::function<void(std::uint64_t, std::span<std::uint64_t>, default_engine&)>;
+
+    // Every algorithm, plus sample_k itself, with the order it produces.
+    std::vector<std::pair<std::string, std::pair<sampler, sample_order>>> all_samplers() {
+        return {
+            {"floyd unsorted", {[](std::uint64_t n, std::span<std::uint64_t> out, default_engine& rng) {
+                sample_detail::floyd(n, out, rng, sample_order::unsorted); }, sample_order::unsorted}},
+            {"floyd sorted", {[](std::uint64_t n, std::span<std::uint64_t> out, default_engine& rng) {
+                sample_detail::floyd(n, out, rng, sample_order::sorted); }, sample_order::sorted}},
+            {"selection", {[](std::uint64_t n, std::span<std::uint64_t> out, default_engine& rng) {
+                sample_detail::selection(n, out, rng); }, sample_order::sorted}},
+            {"shuffled selection", {[](std::uint64_t n, std::span<std::uint64_t> out, default_engine& rng) {
+                sample_detail::shuffled_selection(n, out, rng); }, sample_order::unsorted}},
+            {"sample_k unsorted", {[](std::uint64_t n, std::span<std::uint64_t> out, default_engine& rng) {
+                sample_k(n, out, rng); }, sample_order::unsorted}},
+            {"sample_k sorted", {[](std::uint64_t n, std::span<std::uint64_t> out, default_engine& rng) {
+                sample_k(n, out, rng, sample_order::sorted); }, sample_order::sorted}},
+        };
+    }
+}
+
+TEST_CASE("Sample k of n - Correctness Tests", "[sample]") {
+    SECTION("Samples are distinct, in range and ordered as asked") {
+        for (const auto& [name, entry] : all_samplers()) {
+            const auto& [sample, order] = entry;
+            INFO(name);
+            default_engine rng(1);
+            for (auto [n, k] : std::vector<std::pair<std::uint64_t, std::size_t>>{
+                     {1, 0}, {1, 1}, {2, 2}, {10, 3}, {100, 100}, {1000, 10}, {100000, 5000}, {100000, 90000}}) {
+                std::vector<std::uint64_t> out(k);
+                sample(n, out, rng);
+                if (order == sample_order::sorted) {
+                    REQUIRE(std::is_sorted(out.begin(), out.end()));
+                }
+                std::sort(out.begin(), out.end());
+                REQUIRE(std::adjacent_find(out.begin(), out.end()) == out.end());
+                REQUIRE((out.empty() || out.back() < n));
+            }
+        }
+    }
+
+    SECTION("Ordered 3-samples of 6 are uniform") {
+        // 120 ordered triples for unsorted output, 20 subsets for sorted.
+        for (const auto& [name, entry] : all_samplers()) {
+            const auto& [sample, order] = entry;
+            INFO(name);
+            default_engine rng(2);
+            const int trials = 60000;
+            std::map<std::vector<std::uint64_t>, int> counts;
+            for (int trial = 0; trial < trials; ++trial) {
+                std::vector<std::uint64_t> out(3);
+                sample(6, out, rng);
+                counts[out]++;
+            }
+            const std::size_t cells = order == sample_order::sorted ? 20 : 120;
+            REQUIRE(counts.size() == cells);
+            const double expected = static_cast<double>(trials) / cells;
+            double chi_squared = 0.0;
+            for (const auto& [subset, count] : counts) {
+                const double diff = count - expected;
+                chi_squared += diff * diff / expected;
+            }
+            REQUIRE(chi_squared < (cells - 1) * 2.0);
+        }
+    }
+
+    SECTION("Huge index spaces take memory proportional to k") {
+        default_engine rng(3);
+        std::vector<std::uint64_t> sample = sample_k(UINT64_MAX, 1000, rng, sample_order::sorted);
+        REQUIRE(sample.size() == 1000);
+        REQUIRE(std::adjacent_find(sample.begin(), sample.end()) == sample.end());
+        REQUIRE(sample_k(1000000000000, 10).size() == 10);
+    }
+}
+
+namespace {
+    // ns per sampled index for each algorithm over a sweep of k with n fixed,
+    // against rejecting repeats with std::unordered_set.
+    void report_ns_per_index(std::uint64_t n, std::initializer_list<std::uint64_t> ks, bool include_linear) {
+        default_engine rng(1);
+        auto ns_per_index = [&](std::uint64_t k, auto run) {
+            std::vector<std::uint64_t> out(k);
+            const int repetitions = static_cast<int>(std::max<std::uint64_t>(1, 2000000 / std::max(k, n / 64)));
+            run(out);
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int rep = 0; rep < repetitions; ++rep) {
+                run(out);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(k) * repetitions);
+        };
+
+        std::cout << "\nn = " << n << " (ns per sampled index)\n";
+        for (std::uint64_t k : ks) {
+            std::cout << "k = " << k << ":";
+            std::cout << " hash-set " << ns_per_index(k, [&](std::vector<std::uint64_t>& out) {
+                std::unordered_set<std::uint64_t> taken;
+                std::size_t filled = 0;
+                while (filled < out.size()) {
+                    const std::uint64_t index = bounded_random(rng, n);
+                    if (taken.insert(index).second) out[filled++] = index;
+                }
+            });
+            std::cout << ", floyd " << ns_per_index(k, [&](std::vector<std::uint64_t>& out) {
+                sample_detail::floyd(n, std::span(out), rng, sample_order::unsorted);
+            });
+            std::cout << ", floyd sorted " << ns_per_index(k, [&](std::vector<std::uint64_t>& out) {
+                sample_detail::floyd(n, std::span(out), rng, sample_order::sorted);
+            });
+            if (include_linear) {
+                std::cout << ", selection " << ns_per_index(k, [&](std::vector<std::uint64_t>& out) {
+                    sample_detail::selection(n, std::span(out), rng);
+                });
+                std::cout << ", shuffled selection " << ns_per_index(k, [&](std::vector<std::uint64_t>& out) {
+                    sample_detail::shuffled_selection(n, std::span(out), rng);
+                });
+            }
+            std::cout << ", sample_k " << ns_per_index(k, [&](std::vector<std::uint64_t>& out) {
+                sample_k(n, std::span(out), rng);
+            });
+            std::cout << ", sample_k sorted " << ns_per_index(k, [&](std::vector<std::uint64_t>& out) {
+                sample_k(n, std::span(out), rng, sample_order::sorted);
+            }) << "\n";
+        }
+    }
+}
+
+TEST_CASE("Sample k of n - Algorithm Sweep", "[sample][benchmark]") {
+    // Ratios from 1/10^4 to 1/2 pick out the crossover points.
+    report_ns_per_index(1000000, {100, 1000, 10000, 31250, 62500, 125000, 250000, 500000}, true);
+    report_ns_per_index(1000000000, {10, 1000, 100000}, false);
+
+    default_engine rng(1);
+    BENCHMARK("sample_k(10^9, 1000)") {
+        return sample_k(1000000000, 1000, rng);
+    };
+    BENCHMARK("sample_k(10^6, 10^5, sorted)") {
+        return sample_k(1000000, 100000, rng, sample_order::sorted);
+    };
+}
+
+TEST_CASE("Sample k of n - Large Samples", "[.][sample][benchmark][large]") {
+    report_ns_per_index(1000000000, {10000000}, false);
+}
@@ -7,7 +7,11 @@
 #include <unordered_map>
 #include <cmath>
 #include <iostream>
+#include <array>
+#include <cstdint>
+#include <span>
 #include "../src/shuffle.hpp"
+#include "../src/feistel_permutation.hpp"
 
 TEST_CASE("Shuffle Algorithms - Correctness Tests", "[shuffle]") {
     SECTION("All algorithms preserve array size") {
@@ -94,7 +98,17 @@ TEST_CASE("Shuffle Algorithms - Randomness Quality Tests", "[shuffle][randomness
     };
     
     SECTION("Fisher-Yates produces uniform distribution") {
-        test_distribution("fisher_yates", shuffle_fisher_yates);
+        test_distribution("fisher_yates", [](std::vector<int>& deck) { shuffle_fisher_yates(deck); });
+    }
+
+    SECTION("Feistel permutation produces uniform distribution") {
+        std::uint64_t seed = 0;
+        test_distribution("feistel", [&](std::vector<int>& deck) {
+            feistel_permutation permutation(deck.size(), seed++);
+            for (size_t i = 0; i < deck.size(); ++i) {
+                deck[i] = static_cast<int>(permutation(i));
+            }
+        });
     }
 }
 
@@ -149,15 +163,15 @@ TEST_CASE("Shuffle Algorithms - Multiple Trials Analysis", "[shuffle][trials]")
                 };
                 
                 std::vector<int> copy1 = test_data;
-                double time1 = measure_time(shuffle_random_sort, copy1);
+                double time1 = measure_time([](std::vector<int>& a) { shuffle_random_sort(a); }, copy1);
                 random_sort_times.push_back(time1);
                 
                 std::vector<int> copy2 = test_data;
-                double time2 = measure_time(shuffle_naive_swap, copy2);
+                double time2 = measure_time([](std::vector<int>& a) { shuffle_naive_swap(a); }, copy2);
                 naive_swap_times.push_back(time2);
                 
                 std::vector<int> copy3 = test_data;
-                double time3 = measure_time(shuffle_fisher_yates, copy3);
+                double time3 = measure_time([](std::vector<int>& a) { shuffle_fisher_yates(a); }, copy3);
                 fisher_yates_times.push_back(time3);
             }
             
@@ -220,4 +234,176 @@ TEST_CASE("Shuffle Algorithms - Edge Cases", "[shuffle][edge]") {
         double probability = static_cast<double>(original_first_count) / swaps;
         REQUIRE((probability > 0.4 && probability < 0.6));
     }
-}
\ No newline at end of file
+}
+
+namespace {
+    struct card_record {
+        int id;
+        char payload[60];
+
+        bool operator==(const card_record& other) const { return id == other.id; }
+    };
+    static_assert(sizeof(card_record) == 64);
+
+    template <typename T>
+    std::vector<T> make_sequence(size_t size) {
+        std::vector<T> values(size);
+        for (size_t i = 0; i < size; ++i) {
+            if constexpr (std::is_same_v<T, card_record>) {
+                values[i].id = static_cast<int>(i);
+            } else {
+                values[i] = static_cast<T>(i);
+            }
+        }
+        return values;
+    }
+}
+
+TEST_CASE("Shuffle Algorithms - Generic Element Types", "[shuffle][generic]") {
+    SECTION("uint8_t decks are shuffled in place") {
+        std::vector<std::uint8_t> deck = make_sequence<std::uint8_t>(52);
+        const std::vector<std::uint8_t> original = deck;
+
+        shuffle_random_sort(deck);
+        shuffle_naive_swap(deck);
+        shuffle_fisher_yates(deck);
+
+        REQUIRE(deck.size() == original.size());
+        std::sort(deck.begin(), deck.end());
+        REQUIRE(deck == original);
+    }
+
+    SECTION("spans, std::array and C arrays are accepted") {
+        std::array<std::uint16_t, 416> shoe;
+        std::iota(shoe.begin(), shoe.end(), std::uint16_t{0});
+        shuffle_fisher_yates(shoe);
+        shuffle_fisher_yates(std::span(shoe).first(52));
+        REQUIRE(std::is_permutation(shoe.begin(), shoe.end(), make_sequence<std::uint16_t>(416).begin()));
+
+        int raw[5] = {1, 2, 3, 4, 5};
+        shuffle_naive_swap(raw);
+        std::sort(std::begin(raw), std::end(raw));
+        REQUIRE(std::vector<int>(std::begin(raw), std::end(raw)) == std::vector<int>{1, 2, 3, 4, 5});
+    }
+
+    SECTION("64-byte records keep their contents") {
+        std::vector<card_record> records = make_sequence<card_record>(100);
+        for (auto& record : records) {
+            std::fill(std::begin(record.payload), std::end(record.payload), static_cast<char>(record.id));
+        }
+        shuffle_random_sort(std::span(records));
+
+        for (const auto& record : records) {
+            REQUIRE(record.payload[59] == static_cast<char>(record.id));
+        }
+        REQUIRE(std::is_permutation(records.begin(), records.end(), make_sequence<card_record>(100).begin()));
+    }
+
+    SECTION("Empty and single element spans") {
+        std::span<std::uint8_t> empty;
+        REQUIRE_NOTHROW(shuffle_random_sort(empty));
+        REQUIRE_NOTHROW(shuffle_naive_swap(empty));
+        REQUIRE_NOTHROW(shuffle_fisher_yates(empty));
+
+        std::array<std::uint8_t, 1> single = {42};
+        shuffle_fisher_yates(single);
+        REQUIRE(single[0] == 42);
+    }
+}
+
+TEST_CASE("Shuffle Algorithms - Generic Randomness Quality", "[shuffle][generic][randomness]") {
+    const int TRIALS = 1000;
+    const int ARRAY_SIZE = 52;
+
+    auto chi_squared_for = [&](auto shuffle_func) {
+        std::vector<int> position_counts(ARRAY_SIZE * ARRAY_SIZE, 0);
+
+        for (int trial = 0; trial < TRIALS; ++trial) {
+            std::vector<std::uint8_t> deck = make_sequence<std::uint8_t>(ARRAY_SIZE);
+            shuffle_func(std::span(deck));
+
+            for (int pos = 0; pos < ARRAY_SIZE; ++pos) {
+                position_counts[deck[pos] * ARRAY_SIZE + pos]++;
+            }
+        }
+
+        double expected = static_cast<double>(TRIALS) / ARRAY_SIZE;
+        double chi_squared = 0.0;
+        for (int count : position_counts) {
+            double diff = count - expected;
+            chi_squared += (diff * diff) / expected;
+        }
+        return chi_squared;
+    };
+
+    double max_chi_squared = (ARRAY_SIZE * ARRAY_SIZE - 1) * 2.0;
+
+    REQUIRE(chi_squared_for([](std::span<std::uint8_t> deck) { shuffle_fisher_yates(deck); }) < max_chi_squared);
+    REQUIRE(chi_squared_for([](std::span<std::uint8_t> deck) { shuffle_random_sort(deck); }) < max_chi_squared);
+}
+
+TEST_CASE("Shuffle Algorithms - Generic Element Type Benchmarks", "[shuffle][benchmark]") {
+    const std::vector<size_t> test_sizes = {52, 416, 10000};
+
+    for (size_t size : test_sizes) {
+        SECTION("Element types with size " + std::to_string(size)) {
+            const std::string suffix = " (size=" + std::to_string(size) + ")";
+
+            const std::vector<std::uint8_t> bytes = make_sequence<std::uint8_t>(size);
+            BENCHMARK("uint8_t via vector<int> copy" + suffix) {
+                std::vector<std::uint8_t> copy = bytes;
+                std::vector<int> widened(copy.begin(), copy.end());
+                shuffle_fisher_yates(widened);
+                std::copy(widened.begin(), widened.end(), copy.begin());
+                return copy;
+            };
+            BENCHMARK("uint8_t span" + suffix) {
+                std::vector<std::uint8_t> copy = bytes;
+                shuffle_fisher_yates(std::span(copy));
+                return copy;
+            };
+
+            const std::vector<std::uint16_t> shorts = make_sequence<std::uint16_t>(size);
+            BENCHMARK("uint16_t via vector<int> copy" + suffix) {
+                std::vector<std::uint16_t> copy = shorts;
+                std::vector<int> widened(copy.begin(), copy.end());
+                shuffle_fisher_yates(widened);
+                std::copy(widened.begin(), widened.end(), copy.begin());
+                return copy;
+            };
+            BENCHMARK("uint16_t span" + suffix) {
+                std::vector<std::uint16_t> copy = shorts;
+                shuffle_fisher_yates(std::span(copy));
+                return copy;
+            };
+
+            const std::vector<int> ints = make_sequence<int>(size);
+            BENCHMARK("int vector<int>" + suffix) {
+                std::vector<int> copy = ints;
+                shuffle_fisher_yates(copy);
+                return copy;
+            };
+            BENCHMARK("int span" + suffix) {
+                std::vector<int> copy = ints;
+                shuffle_fisher_yates(std::span(copy));
+                return copy;
+            };
+
+            const std::vector<card_record> records = make_sequence<card_record>(size);
+            BENCHMARK("64-byte struct via vector<int> indices" + suffix) {
+                std::vector<int> order = make_sequence<int>(size);
+                shuffle_fisher_yates(order);
+                std::vector<card_record> shuffled(size);
+                for (size_t i = 0; i < size; ++i) {
+                    shuffled[i] = records[order[i]];
+                }
+                return shuffled;
+            };
+            BENCHMARK("64-byte struct span" + suffix) {
+                std::vector<card_record> copy = records;
+                shuffle_fisher_yates(std::span(copy));
+                return copy;
+            };
+        }
+    }
+}
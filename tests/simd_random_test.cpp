@@ -0,0 +1,172 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <iostream>
+#include "../src/simd_random.hpp"
+#include "../src/shuffle.hpp"
+
+namespace {
+    std::vector<simd_backend> supported_backends() {
+        std::vector<simd_backend> backends;
+        for (simd_backend backend : {simd_backend::scalar, simd_backend::avx2, simd_backend::avx512}) {
+            if (simd_backend_supported(backend)) {
+                backends.push_back(backend);
+            }
+        }
+        return backends;
+    }
+}
+
+TEST_CASE("SIMD Random - Correctness Tests", "[simd_random]") {
+    SECTION("Lane k is stream k of the same master seed") {
+        xoshiro256ss_x8 rng(42, simd_backend::scalar);
+        rng_stream_manager manager(42);
+        std::vector<default_engine> streams = manager.streams(xoshiro256ss_x8::lanes);
+        for (int step = 0; step < 1000; ++step) {
+            for (auto& stream : streams) {
+                REQUIRE(rng() == stream());
+            }
+        }
+    }
+
+    SECTION("Every supported backend produces the same words") {
+        std::vector<std::uint64_t> expected(10000);
+        xoshiro256ss_x8(7, simd_backend::scalar).fill(expected.data(), expected.size());
+        for (simd_backend backend : supported_backends()) {
+            INFO("backend " << simd_backend_name(backend));
+            std::vector<std::uint64_t> words(expected.size());
+            xoshiro256ss_x8(7, backend).fill(words.data(), words.size());
+            REQUIRE(words == expected);
+        }
+    }
+
+    SECTION("fill() continues the operator() sequence") {
+        xoshiro256ss_x8 single(3);
+        xoshiro256ss_x8 bulk(3);
+        for (size_t count : {1, 5, 8, 13, 511, 512, 1000, 4099}) {
+            std::vector<std::uint64_t> words(count);
+            bulk.fill(words.data(), count);
+            for (std::uint64_t word : words) {
+                REQUIRE(word == single());
+            }
+        }
+        REQUIRE(bulk() == single());
+    }
+
+    SECTION("Drives the generic shuffles") {
+        xoshiro256ss_x8 rng(5);
+        std::vector<int> values(100000);
+        std::iota(values.begin(), values.end(), 0);
+        shuffle_fisher_yates(values, rng);
+        shuffle_naive_swap(values, rng);
+        std::sort(values.begin(), values.end());
+        for (int i = 0; i < static_cast<int>(values.size()); ++i) {
+            REQUIRE(values[i] == i);
+        }
+    }
+}
+
+TEST_CASE("SIMD Random - Randomness Quality Tests", "[simd_random][randomness]") {
+    SECTION("Fisher-Yates card positions are uniform") {
+        xoshiro256ss_x8 rng(9);
+        const int TRIALS = 1000;
+        const int ARRAY_SIZE = 52;
+        std::vector<int> position_counts(ARRAY_SIZE * ARRAY_SIZE, 0);
+        for (int trial = 0; trial < TRIALS; ++trial) {
+            std::vector<int> deck(ARRAY_SIZE);
+            std::iota(deck.begin(), deck.end(), 0);
+            shuffle_fisher_yates(deck, rng);
+            for (int pos = 0; pos < ARRAY_SIZE; ++pos) {
+                position_counts[deck[pos] * ARRAY_SIZE + pos]++;
+            }
+        }
+
+        double expected = static_cast<double>(TRIALS) / ARRAY_SIZE;
+        double chi_squared = 0.0;
+        for (int count : position_counts) {
+            double diff = count - expected;
+            chi_squared += (diff * diff) / expected;
+        }
+        REQUIRE(chi_squared < (ARRAY_SIZE * ARRAY_SIZE - 1) * 2.0);
+    }
+}
+
+namespace {
+    template <typename Generate>
+    double gigabytes_per_second(size_t bytes, Generate generate) {
+        generate();
+        auto start = std::chrono::high_resolution_clock::now();
+        const int repetitions = 20;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            generate();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return static_cast<double>(bytes) * repetitions / std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    template <typename Engine>
+    double engine_gigabytes_per_second(Engine& rng, std::vector<std::uint64_t>& words) {
+        using result_type = typename Engine::result_type;
+        const size_t count = words.size() * sizeof(std::uint64_t) / sizeof(result_type);
+        auto* out = reinterpret_cast<result_type*>(words.data());
+        return gigabytes_per_second(words.size() * sizeof(std::uint64_t), [&] {
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = static_cast<result_type>(rng());
+            }
+        });
+    }
+}
+
+TEST_CASE("SIMD Random - Throughput", "[simd_random][benchmark]") {
+    std::cout << "\nDetected backend: " << simd_backend_name(best_simd_backend()) << "\n";
+
+    std::vector<std::uint64_t> words(1 << 16);
+    std::mt19937 mt(1);
+    std::mt19937_64 mt64(1);
+    default_engine xoshiro(1);
+    std::cout << "std::mt19937: " << engine_gigabytes_per_second(mt, words) << " GB/s\n";
+    std::cout << "std::mt19937_64: " << engine_gigabytes_per_second(mt64, words) << " GB/s\n";
+    std::cout << "xoshiro256**: " << engine_gigabytes_per_second(xoshiro, words) << " GB/s\n";
+
+    for (simd_backend backend : supported_backends()) {
+        xoshiro256ss_x8 rng(1, backend);
+        double per_call = engine_gigabytes_per_second(rng, words);
+        double bulk = gigabytes_per_second(words.size() * sizeof(std::uint64_t), [&] {
+            rng.fill(words.data(), words.size());
+        });
+        std::cout << "xoshiro256**x8 " << simd_backend_name(backend) << ": " << per_call
+                  << " GB/s per call, " << bulk << " GB/s fill()\n";
+    }
+
+    std::vector<int> values(1000000);
+    std::iota(values.begin(), values.end(), 0);
+    std::mt19937 mt_shuffle(2);
+    default_engine scalar_shuffle(2);
+    xoshiro256ss_x8 simd_shuffle(2);
+
+    BENCHMARK("Fisher-Yates std::mt19937 (size=1000000)") {
+        shuffle_fisher_yates(values, mt_shuffle);
+        return values[0];
+    };
+    BENCHMARK("Fisher-Yates xoshiro256** (size=1000000)") {
+        shuffle_fisher_yates(values, scalar_shuffle);
+        return values[0];
+    };
+    BENCHMARK("Fisher-Yates xoshiro256**x8 (size=1000000)") {
+        shuffle_fisher_yates(values, simd_shuffle);
+        return values[0];
+    };
+    BENCHMARK("Naive swap std::mt19937 (size=1000000)") {
+        shuffle_naive_swap(values, mt_shuffle);
+        return values[0];
+    };
+    BENCHMARK("Naive swap xoshiro256**x8 (size=1000000)") {
+        shuffle_naive_swap(values, simd_shuffle);
+        return values[0];
+    };
+}
@@ -0,0 +1,218 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include "../src/weighted_shuffle.hpp"
+
+namespace {
+    std::vector<simd_backend> supported_backends() {
+        std::vector<simd_backend> backends;
+        for (simd_backend backend : {simd_backend::scalar, simd_backend::avx2, simd_backend::avx512}) {
+            if (simd_backend_supported(backend)) backends.push_back(backend);
+        }
+        return backends;
+    }
+
+    std::vector<double> random_weights(std::size_t size, std::uint64_t seed) {
+        default_engine rng(seed);
+        std::vector<double> weights(size);
+        for (double& weight : weights) {
+            weight = 0.01 + static_cast<double>(bounded_random(rng, 1000));
+        }
+        return weights;
+    }
+}
+
+TEST_CASE("Weighted Shuffle - Correctness Tests", "[weighted]") {
+    SECTION("Full orders are permutations, top-k is their prefix") {
+        for (std::size_t size : {1, 2, 17, 1000, 70000, 300000}) {
+            const std::vector<double> weights = random_weights(size, size);
+            std::vector<std::uint32_t> order(size);
+            weighted_order(weights, std::span(order), default_engine(1));
+
+            for (std::size_t k : {std::size_t{1}, std::size_t{10}, size / 20, size / 2}) {
+                if (k == 0 || k > size) continue;
+                std::vector<std::uint32_t> prefix(k);
+                weighted_order(weights, std::span(prefix), default_engine(1));
+                REQUIRE(std::equal(prefix.begin(), prefix.end(), order.begin()));
+            }
+
+            std::sort(order.begin(), order.end());
+            for (std::size_t i = 0; i < size; ++i) {
+                REQUIRE(order[i] == i);
+            }
+        }
+    }
+
+    SECTION("Every backend and thread count gives the same order") {
+        const std::vector<double> weights = random_weights(200000, 2);
+        std::vector<std::uint32_t> expected(200000);
+        weighted_order(weights, std::span(expected), default_engine(3), 1, simd_backend::scalar);
+        for (simd_backend backend : supported_backends()) {
+            for (std::size_t threads : {1, 3}) {
+                std::vector<std::uint32_t> order(200000);
+                weighted_order(weights, std::span(order), default_engine(3), threads, backend);
+                REQUIRE(order == expected);
+            }
+        }
+    }
+
+    SECTION("Zero weights come last") {
+        std::vector<double> weights(1000, 0.0);
+        for (std::size_t i = 0; i < 1000; i += 10) {
+            weights[i] = 1.0;
+        }
+        std::vector<std::uint32_t> order = weighted_order(weights, 1000, default_engine(4));
+        for (std::size_t i = 0; i < 100; ++i) {
+            REQUIRE(order[i] % 10 == 0);
+        }
+    }
+
+    SECTION("weighted_shuffle moves items with their weights") {
+        std::vector<std::string> items = {"ace", "king", "queen", "jack"};
+        const std::vector<double> weights = {1.0, 0.0, 2.0, 3.0};
+        weighted_shuffle(items, weights, default_engine(5));
+        REQUIRE(items.back() == "king");
+        std::sort(items.begin(), items.end());
+        REQUIRE(items == std::vector<std::string>{"ace", "jack", "king", "queen"});
+    }
+}
+
+TEST_CASE("Weighted Shuffle - Statistical Validation", "[weighted][randomness]") {
+    SECTION("Orders of four items follow successive weighted draws") {
+        // P(order) = prod w[order[i]] / (weight left before draw i).
+        const std::vector<double> weights = {1.0, 2.0, 3.0, 4.0};
+        std::vector<std::uint32_t> order = {0, 1, 2, 3};
+        std::vector<double> expected_probability;
+        std::vector<std::vector<std::uint32_t>> orders;
+        do {
+            double probability = 1.0;
+            double left = 10.0;
+            for (std::uint32_t item : order) {
+                probability *= weights[item] / left;
+                left -= weights[item];
+            }
+            orders.push_back(order);
+            expected_probability.push_back(probability);
+        } while (std::next_permutation(order.begin(), order.end()));
+
+        const int trials = 200000;
+        std::vector<int> counts(orders.size(), 0);
+        default_engine rng(6);
+        std::vector<std::uint32_t> drawn(4);
+        for (int trial = 0; trial < trials; ++trial) {
+            weighted_order(weights, std::span(drawn), rng, 1);
+            counts[std::find(orders.begin(), orders.end(), drawn) - orders.begin()]++;
+        }
+        double chi_squared = 0.0;
+        for (std::size_t i = 0; i < orders.size(); ++i) {
+            const double expected = trials * expected_probability[i];
+            const double diff = counts[i] - expected;
+            chi_squared += diff * diff / expected;
+        }
+        REQUIRE(chi_squared < 23 * 2.0);
+    }
+
+    SECTION("The first item is drawn in proportion to its weight") {
+        const std::vector<double> weights = random_weights(50, 7);
+        const double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+        const int trials = 100000;
+        std::vector<int> counts(50, 0);
+        default_engine rng(8);
+        std::vector<std::uint32_t> first(1);
+        for (int trial = 0; trial < trials; ++trial) {
+            weighted_order(weights, std::span(first), rng, 1);
+            counts[first[0]]++;
+        }
+        double chi_squared = 0.0;
+        for (std::size_t i = 0; i < 50; ++i) {
+            const double expected = trials * weights[i] / total;
+            const double diff = counts[i] - expected;
+            chi_squared += diff * diff / expected;
+        }
+        REQUIRE(chi_squared < 49 * 2.0);
+    }
+
+    SECTION("Items with colliding keys are not left in index order") {
+        // Float keys of 4 million items collide thousands of times.
+        const std::size_t size = 4000000;
+        const std::vector<double> weights(size, 1.0);
+        default_engine rng(9);
+        default_engine key_rng = rng;
+        const std::vector<std::uint64_t> records =
+            weighted_shuffle_detail::key_records(std::span<const double>(weights), key_rng, 0, best_simd_backend());
+        std::vector<std::uint32_t> order(size);
+        weighted_order(weights, std::span(order), rng);
+
+        std::size_t ties = 0;
+        std::size_t index_ordered = 0;
+        for (std::size_t i = 0; i + 1 < size; ++i) {
+            if ((records[order[i]] >> 32) == (records[order[i + 1]] >> 32)) {
+                ++ties;
+                index_ordered += order[i] < order[i + 1];
+            }
+        }
+        REQUIRE(ties > 1000);
+        const double fraction = static_cast<double>(index_ordered) / static_cast<double>(ties);
+        REQUIRE(fraction > 0.45);
+        REQUIRE(fraction < 0.55);
+    }
+}
+
+namespace {
+    void report_ns_per_item(const std::vector<std::size_t>& sizes) {
+        for (std::size_t size : sizes) {
+            const std::vector<double> weights = random_weights(size, size);
+            std::vector<std::uint32_t> order(size);
+            default_engine rng(1);
+            const int repetitions = static_cast<int>(std::max<std::size_t>(1, 10000000 / size));
+
+            auto ns_per_item = [&](auto run) {
+                run();
+                auto start = std::chrono::high_resolution_clock::now();
+                for (int rep = 0; rep < repetitions; ++rep) {
+                    run();
+                }
+                auto end = std::chrono::high_resolution_clock::now();
+                return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(size) * repetitions);
+            };
+
+            std::cout << "\nItems: " << size << "\n";
+            for (simd_backend backend : supported_backends()) {
+                const double keys = ns_per_item([&] {
+                    auto records = weighted_shuffle_detail::key_records(std::span<const double>(weights), rng, 0, backend);
+                    return records[0];
+                });
+                std::cout << "Keys (" << simd_backend_name(backend) << "): " << keys << " ns/item\n";
+            }
+            const double full = ns_per_item([&] { weighted_order(weights, std::span(order), rng); });
+            const double top = ns_per_item([&] { weighted_order(weights, std::span(order).first(std::max<std::size_t>(1, size / 100)), rng); });
+            std::cout << "Full order: " << full << " ns/item, first 1%: " << top << " ns/item\n";
+        }
+    }
+}
+
+TEST_CASE("Weighted Shuffle - Size Sweep", "[weighted][benchmark]") {
+    report_ns_per_item({1000, 100000, 10000000});
+
+    const std::vector<double> weights = random_weights(1000000, 1);
+    std::vector<std::uint32_t> order(1000000);
+    default_engine rng(1);
+    BENCHMARK("weighted_order full (size=1000000)") {
+        weighted_order(weights, std::span(order), rng);
+        return order[0];
+    };
+    BENCHMARK("weighted_order top 100 (size=1000000)") {
+        weighted_order(weights, std::span(order).first(100), rng);
+        return order[0];
+    };
+}
+
+TEST_CASE("Weighted Shuffle - 10^8 Items", "[.][weighted][benchmark][large]") {
+    report_ns_per_item({100000000});
+}